@@ -0,0 +1,234 @@
+#include "AbilityCache.h"
+#include "CCBot.h"
+
+// 22.4 game loops per second on faster
+const uint32_t kd8ChargeCooldown = 314;
+const uint32_t afterburnersCooldown = 314;
+const uint32_t stimDuration = 246;
+const float energyPerLoop = 0.7875f / 22.4f;
+const float calldownEnergy = 50.0f;
+// every so often we ask the game if our cooldowns are still right
+const uint32_t reconcileInterval = 224;
+const uint32_t neverReady = std::numeric_limits<uint32_t>::max();
+
+AbilityCache::AbilityCache(CCBot & bot)
+	: m_bot(bot)
+	, m_deferred(false)
+	, m_lastReconcile(0)
+{
+
+}
+
+void AbilityCache::onFrame()
+{
+	ProfileScope profile(m_bot.Profiler(), "Abilities");
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	for (const auto & unit : m_bot.UnitInfo().getUnitDeltas().destroyed)
+	{
+		m_entries.erase(unit->tag);
+		m_lastCast.erase(m_lastCast.lower_bound(std::make_pair(unit->tag, 0u)), m_lastCast.upper_bound(std::make_pair(unit->tag, std::numeric_limits<uint32_t>::max())));
+		m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), unit), m_pending.end());
+	}
+	if (m_deferred)
+	{
+		m_deferred = false;
+		resolvePending();
+	}
+	m_pending.clear();
+	if (m_bot.Observation()->GetGameLoop() - m_lastReconcile >= reconcileInterval)
+	{
+		reconcile();
+	}
+}
+
+// only the cooldowns can drift, energy and buffs we read from the observation
+void AbilityCache::reconcile()
+{
+	const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+	m_lastReconcile = gameLoop;
+	sc2::Units onCooldown;
+	for (const auto & cast : m_lastCast)
+	{
+		const sc2::Unit * unit = m_bot.GetUnit(cast.first.first);
+		const uint32_t loops = unit ? loopsUntilReady(unit, cast.first.second) : 0;
+		if (loops > 0 && loops != neverReady)
+		{
+			onCooldown.push_back(unit);
+		}
+	}
+	if (onCooldown.empty())
+	{
+		return;
+	}
+	request(onCooldown);
+	for (auto & cast : m_lastCast)
+	{
+		const sc2::Unit * unit = m_bot.GetUnit(cast.first.first);
+		if (unit && std::find(onCooldown.begin(), onCooldown.end(), unit) != onCooldown.end() && loopsUntilReady(unit, cast.first.second) > 0 && canCast(unit, cast.first.second))
+		{
+			// the cast did not happen or the cooldown is shorter than we think
+			cast.second = 0;
+		}
+	}
+}
+
+uint32_t AbilityCache::loopsUntilReady(const sc2::Unit * unit, const sc2::AbilityID & ability) const
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+	const auto it = m_lastCast.find(std::make_pair(unit->tag, static_cast<uint32_t>(ability)));
+	const uint32_t lastCast = it == m_lastCast.end() ? 0 : it->second;
+	const auto cooldownLeft = [gameLoop, lastCast](uint32_t cooldown) -> uint32_t
+	{
+		return lastCast == 0 || gameLoop >= lastCast + cooldown ? 0 : lastCast + cooldown - gameLoop;
+	};
+
+	switch (ability.ToType())
+	{
+		case sc2::ABILITY_ID::EFFECT_STIM:
+		{
+			// only bio stims, everything else that kites has to keep kiting
+			const bool marauder = unit->unit_type == sc2::UNIT_TYPEID::TERRAN_MARAUDER;
+			if (!marauder && unit->unit_type != sc2::UNIT_TYPEID::TERRAN_MARINE)
+			{
+				return neverReady;
+			}
+			const float healthCost = marauder ? 20.0f : 10.0f;
+			if (!m_bot.UnitInfo().hasUpgrade(sc2::UPGRADE_ID::STIMPACK) || unit->health <= healthCost)
+			{
+				return neverReady;
+			}
+			const bool stimmed = std::find(unit->buffs.begin(), unit->buffs.end(), sc2::BUFF_ID::STIMPACK) != unit->buffs.end()
+				|| std::find(unit->buffs.begin(), unit->buffs.end(), sc2::BUFF_ID::STIMPACKMARAUDER) != unit->buffs.end();
+			if (!stimmed)
+			{
+				return 0;
+			}
+			// a stim we did not see being cast could last the full duration
+			return std::max(cooldownLeft(stimDuration), lastCast == 0 ? stimDuration : 1u);
+		}
+		case sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS:
+			return cooldownLeft(afterburnersCooldown);
+		case sc2::ABILITY_ID::EFFECT_KD8CHARGE:
+			return cooldownLeft(kd8ChargeCooldown);
+		case sc2::ABILITY_ID::EFFECT_SCAN:
+		case sc2::ABILITY_ID::EFFECT_CALLDOWNMULE:
+		{
+			if (unit->unit_type != sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND || unit->build_progress < 1.0f)
+			{
+				return neverReady;
+			}
+			if (unit->energy >= calldownEnergy)
+			{
+				return 0;
+			}
+			return static_cast<uint32_t>(std::ceil((calldownEnergy - unit->energy) / energyPerLoop));
+		}
+		default:
+			return neverReady;
+	}
+}
+
+bool AbilityCache::isReady(const sc2::Unit * unit, const sc2::AbilityID & ability)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	switch (ability.ToType())
+	{
+		case sc2::ABILITY_ID::EFFECT_STIM:
+		case sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS:
+		case sc2::ABILITY_ID::EFFECT_KD8CHARGE:
+		case sc2::ABILITY_ID::EFFECT_SCAN:
+		case sc2::ABILITY_ID::EFFECT_CALLDOWNMULE:
+			return loopsUntilReady(unit, ability) == 0;
+		default:
+			return canCast(unit, ability);
+	}
+}
+
+void AbilityCache::onCast(const sc2::Unit * unit, const sc2::AbilityID & ability)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	m_lastCast[std::make_pair(unit->tag, static_cast<uint32_t>(ability))] = m_bot.Observation()->GetGameLoop();
+}
+
+bool AbilityCache::isCurrent(const sc2::Unit * unit) const
+{
+	const auto it = m_entries.find(unit->tag);
+	return it != m_entries.end() && it->second.gameLoop == m_bot.Observation()->GetGameLoop();
+}
+
+void AbilityCache::request(const sc2::Unit * unit)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	if (unit && !isCurrent(unit) && std::find(m_pending.begin(), m_pending.end(), unit) == m_pending.end())
+	{
+		m_pending.push_back(unit);
+	}
+}
+
+void AbilityCache::request(const sc2::Units & units)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	for (const auto & unit : units)
+	{
+		request(unit);
+	}
+}
+
+void AbilityCache::resolvePending()
+{
+	if (m_pending.empty())
+	{
+		return;
+	}
+	const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+	std::vector<sc2::AvailableAbilities> results;
+	{
+		ProfileScope query(m_bot.Profiler(), "Query Abilities", "api");
+		results = m_bot.Query()->GetAbilitiesForUnits(m_pending);
+	}
+	for (size_t i = 0; i < m_pending.size(); ++i)
+	{
+		Entry & entry = m_entries[m_pending[i]->tag];
+		entry.gameLoop = gameLoop;
+		entry.abilities.clear();
+		// the answers come in the same order, but better check the tag
+		if (i < results.size() && results[i].unit_tag == m_pending[i]->tag)
+		{
+			entry.abilities = results[i].abilities;
+		}
+	}
+	m_pending.clear();
+}
+
+const std::vector<sc2::AvailableAbility> & AbilityCache::getAbilities(const sc2::Unit * unit)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	BOT_ASSERT(unit, "Unit pointer was null");
+	if (!isCurrent(unit))
+	{
+		request(unit);
+		if (m_bot.Scheduler().isRunningAhead())
+		{
+			// the last answer, or none for a new unit
+			m_deferred = true;
+		}
+		else
+		{
+			resolvePending();
+		}
+	}
+	return m_entries[unit->tag].abilities;
+}
+
+bool AbilityCache::canCast(const sc2::Unit * unit, const sc2::AbilityID & ability)
+{
+	for (const auto & available : getAbilities(unit))
+	{
+		if (available.ability_id == ability)
+		{
+			return true;
+		}
+	}
+	return false;
+}
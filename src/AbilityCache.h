@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+
+class CCBot;
+
+// available abilities of our units. All units requested during a frame are resolved with one query
+// and the result is kept for the rest of the game loop. Tasks running ahead get the last answer, their units are asked about in the next onFrame.
+// Stim, afterburners, KD8 charges, scans and MULEs are predicted locally from our own casts, energy and buffs.
+class AbilityCache
+{
+	struct Entry
+	{
+		uint32_t gameLoop;
+		std::vector<sc2::AvailableAbility> abilities;
+
+		Entry() : gameLoop(0) {}
+	};
+
+	CCBot &		m_bot;
+	std::unordered_map<sc2::Tag, Entry> m_entries;
+	sc2::Units	m_pending;
+	bool		m_deferred;		// a task running ahead left units in m_pending
+
+	std::map<std::pair<sc2::Tag, uint32_t>, uint32_t> m_lastCast;	// game loop of our last cast per unit and ability
+	uint32_t	m_lastReconcile;
+	// squads ask from several threads
+	mutable std::recursive_mutex m_mutex;
+
+	bool		isCurrent(const sc2::Unit * unit) const;
+	void		resolvePending();
+	void		reconcile();
+
+public:
+
+	AbilityCache(CCBot & bot);
+
+	void		onFrame();
+
+	// announce units we are going to ask about, so they are part of the next batch
+	void		request(const sc2::Unit * unit);
+	void		request(const sc2::Units & units);
+
+	const std::vector<sc2::AvailableAbility> & getAbilities(const sc2::Unit * unit);
+	bool		canCast(const sc2::Unit * unit, const sc2::AbilityID & ability);
+
+	// answered by the local model, only for the abilities it knows. Everything else falls back to canCast.
+	bool		isReady(const sc2::Unit * unit, const sc2::AbilityID & ability);
+	uint32_t	loopsUntilReady(const sc2::Unit * unit, const sc2::AbilityID & ability) const;
+	void		onCast(const sc2::Unit * unit, const sc2::AbilityID & ability);
+};
@@ -0,0 +1,133 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// keeps the blocks aligned as malloc returns them
+	const size_t headerSize = 16;
+
+	std::atomic<bool> enabled(false);
+	std::atomic<size_t> allocationCount(0);
+	std::atomic<size_t> allocatedBytes(0);
+	std::atomic<size_t> live(0);
+	std::atomic<size_t> peak(0);
+	thread_local size_t threadAllocationCount = 0;
+	thread_local size_t threadAllocatedBytes = 0;
+
+	void * allocate(size_t size)
+	{
+		char * block = static_cast<char *>(std::malloc(size + headerSize));
+		if (!block)
+		{
+			return nullptr;
+		}
+		size_t counted = 0;
+		if (enabled.load(std::memory_order_relaxed))
+		{
+			counted = size;
+			++threadAllocationCount;
+			threadAllocatedBytes += size;
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+			allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+			const size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+			size_t highest = peak.load(std::memory_order_relaxed);
+			while (now > highest && !peak.compare_exchange_weak(highest, now, std::memory_order_relaxed))
+			{
+			}
+		}
+		*reinterpret_cast<size_t *>(block) = counted;
+		return block + headerSize;
+	}
+
+	void release(void * pointer)
+	{
+		if (!pointer)
+		{
+			return;
+		}
+		char * block = static_cast<char *>(pointer) - headerSize;
+		const size_t counted = *reinterpret_cast<size_t *>(block);
+		if (counted > 0)
+		{
+			live.fetch_sub(counted, std::memory_order_relaxed);
+		}
+		std::free(block);
+	}
+}
+
+void * operator new(size_t size)
+{
+	void * pointer = allocate(size);
+	if (!pointer)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+	release(pointer);
+}
+
+void operator delete(void * pointer, const std::nothrow_t &) noexcept
+{
+	release(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept
+{
+	release(pointer);
+}
+
+void AllocationTracker::setEnabled(bool enable)
+{
+	enabled = enable;
+}
+
+bool AllocationTracker::isEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+size_t AllocationTracker::threadAllocations()
+{
+	return threadAllocationCount;
+}
+
+size_t AllocationTracker::threadBytes()
+{
+	return threadAllocatedBytes;
+}
+
+size_t AllocationTracker::allocations()
+{
+	return allocationCount.load();
+}
+
+size_t AllocationTracker::bytes()
+{
+	return allocatedBytes.load();
+}
+
+size_t AllocationTracker::liveBytes()
+{
+	return live.load();
+}
+
+size_t AllocationTracker::peakBytes()
+{
+	return peak.load();
+}
+
+void AllocationTracker::resetPeak()
+{
+	peak = live.load();
+}
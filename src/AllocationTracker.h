@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+// replaces the global operator new and delete. While enabled it counts every allocation of the process, and per thread,
+// so a ProfileScope can tell how much its zone allocated. TrackAllocations enables it, the micro benchmarks too.
+// Each block carries its counted size in front of it, so a delete after disabling does not miscount.
+namespace AllocationTracker
+{
+	void	setEnabled(bool enabled);
+	bool	isEnabled();
+
+	// of the calling thread, counted while enabled
+	size_t	threadAllocations();
+	size_t	threadBytes();
+
+	// of all threads, counted while enabled
+	size_t	allocations();
+	size_t	bytes();
+	size_t	liveBytes();
+	size_t	peakBytes();
+	// the peak starts again from what is live now
+	void	resetPeak();
+}
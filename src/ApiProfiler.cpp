@@ -0,0 +1,474 @@
+#include "ApiProfiler.h"
+#include "ModuleProfiler.h"
+#include <algorithm>
+#include <iomanip>
+
+ApiCallSite::ApiCallSite()
+	: calls(0)
+	, totalMs(0.0)
+	, maxMs(0.0)
+	, elements(0)
+	, stepCalls(0)
+	, stepMs(0.0)
+	, stepElements(0)
+{
+
+}
+
+void ApiCallSite::addStep()
+{
+	calls += stepCalls;
+	totalMs += stepMs;
+	maxMs = std::max(maxMs, stepMs);
+	elements += stepElements;
+	stepCalls = 0;
+	stepMs = 0.0;
+	stepElements = 0;
+}
+
+ApiCall::ApiCall(ApiProfiler & profiler, const char * function)
+	: m_profiler(profiler.isEnabled() ? &profiler : nullptr)
+	, m_function(function)
+	, m_elements(1)
+{
+	if (m_profiler)
+	{
+		m_timer.start();
+	}
+}
+
+ApiCall::~ApiCall()
+{
+	if (m_profiler)
+	{
+		m_profiler->record(m_function, m_timer.getElapsedTimeInMilliSec(), m_elements);
+	}
+}
+
+void ApiCall::setElements(size_t elements)
+{
+	m_elements = elements;
+}
+
+CountingObservation::CountingObservation(ApiProfiler & profiler)
+	: m_profiler(profiler)
+	, m_observation(nullptr)
+{
+
+}
+
+void CountingObservation::setObservation(const sc2::ObservationInterface * observation)
+{
+	m_observation = observation;
+}
+
+uint32_t CountingObservation::GetPlayerID() const
+{
+	ApiCall call(m_profiler, "GetPlayerID");
+	return m_observation->GetPlayerID();
+}
+
+uint32_t CountingObservation::GetGameLoop() const
+{
+	ApiCall call(m_profiler, "GetGameLoop");
+	return m_observation->GetGameLoop();
+}
+
+sc2::Units CountingObservation::GetUnits() const
+{
+	ApiCall call(m_profiler, "GetUnits");
+	sc2::Units units = m_observation->GetUnits();
+	call.setElements(units.size());
+	return units;
+}
+
+sc2::Units CountingObservation::GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter) const
+{
+	ApiCall call(m_profiler, "GetUnits");
+	sc2::Units units = m_observation->GetUnits(alliance, filter);
+	call.setElements(units.size());
+	return units;
+}
+
+sc2::Units CountingObservation::GetUnits(sc2::Filter filter) const
+{
+	ApiCall call(m_profiler, "GetUnits");
+	sc2::Units units = m_observation->GetUnits(filter);
+	call.setElements(units.size());
+	return units;
+}
+
+const sc2::Unit * CountingObservation::GetUnit(sc2::Tag tag) const
+{
+	ApiCall call(m_profiler, "GetUnit");
+	return m_observation->GetUnit(tag);
+}
+
+const sc2::RawActions & CountingObservation::GetRawActions() const
+{
+	ApiCall call(m_profiler, "GetRawActions");
+	return m_observation->GetRawActions();
+}
+
+const sc2::SpatialActions & CountingObservation::GetFeatureLayerActions() const
+{
+	ApiCall call(m_profiler, "GetFeatureLayerActions");
+	return m_observation->GetFeatureLayerActions();
+}
+
+const sc2::SpatialActions & CountingObservation::GetRenderedActions() const
+{
+	ApiCall call(m_profiler, "GetRenderedActions");
+	return m_observation->GetRenderedActions();
+}
+
+const std::vector<sc2::ChatMessage> & CountingObservation::GetChatMessages() const
+{
+	ApiCall call(m_profiler, "GetChatMessages");
+	return m_observation->GetChatMessages();
+}
+
+const std::vector<sc2::PowerSource> & CountingObservation::GetPowerSources() const
+{
+	ApiCall call(m_profiler, "GetPowerSources");
+	return m_observation->GetPowerSources();
+}
+
+const std::vector<sc2::Effect> & CountingObservation::GetEffects() const
+{
+	ApiCall call(m_profiler, "GetEffects");
+	return m_observation->GetEffects();
+}
+
+const std::vector<sc2::UpgradeID> & CountingObservation::GetUpgrades() const
+{
+	ApiCall call(m_profiler, "GetUpgrades");
+	return m_observation->GetUpgrades();
+}
+
+const sc2::Score & CountingObservation::GetScore() const
+{
+	ApiCall call(m_profiler, "GetScore");
+	return m_observation->GetScore();
+}
+
+const sc2::Abilities & CountingObservation::GetAbilityData(bool force_refresh) const
+{
+	ApiCall call(m_profiler, "GetAbilityData");
+	return m_observation->GetAbilityData(force_refresh);
+}
+
+const sc2::UnitTypes & CountingObservation::GetUnitTypeData(bool force_refresh) const
+{
+	ApiCall call(m_profiler, "GetUnitTypeData");
+	return m_observation->GetUnitTypeData(force_refresh);
+}
+
+const sc2::Upgrades & CountingObservation::GetUpgradeData(bool force_refresh) const
+{
+	ApiCall call(m_profiler, "GetUpgradeData");
+	return m_observation->GetUpgradeData(force_refresh);
+}
+
+const sc2::Buffs & CountingObservation::GetBuffData(bool force_refresh) const
+{
+	ApiCall call(m_profiler, "GetBuffData");
+	return m_observation->GetBuffData(force_refresh);
+}
+
+const sc2::Effects & CountingObservation::GetEffectData(bool force_refresh) const
+{
+	ApiCall call(m_profiler, "GetEffectData");
+	return m_observation->GetEffectData(force_refresh);
+}
+
+const sc2::GameInfo & CountingObservation::GetGameInfo() const
+{
+	ApiCall call(m_profiler, "GetGameInfo");
+	return m_observation->GetGameInfo();
+}
+
+int32_t CountingObservation::GetMinerals() const
+{
+	ApiCall call(m_profiler, "GetMinerals");
+	return m_observation->GetMinerals();
+}
+
+int32_t CountingObservation::GetVespene() const
+{
+	ApiCall call(m_profiler, "GetVespene");
+	return m_observation->GetVespene();
+}
+
+int32_t CountingObservation::GetFoodCap() const
+{
+	ApiCall call(m_profiler, "GetFoodCap");
+	return m_observation->GetFoodCap();
+}
+
+int32_t CountingObservation::GetFoodUsed() const
+{
+	ApiCall call(m_profiler, "GetFoodUsed");
+	return m_observation->GetFoodUsed();
+}
+
+int32_t CountingObservation::GetFoodArmy() const
+{
+	ApiCall call(m_profiler, "GetFoodArmy");
+	return m_observation->GetFoodArmy();
+}
+
+int32_t CountingObservation::GetFoodWorkers() const
+{
+	ApiCall call(m_profiler, "GetFoodWorkers");
+	return m_observation->GetFoodWorkers();
+}
+
+int32_t CountingObservation::GetIdleWorkerCount() const
+{
+	ApiCall call(m_profiler, "GetIdleWorkerCount");
+	return m_observation->GetIdleWorkerCount();
+}
+
+int32_t CountingObservation::GetArmyCount() const
+{
+	ApiCall call(m_profiler, "GetArmyCount");
+	return m_observation->GetArmyCount();
+}
+
+int32_t CountingObservation::GetWarpGateCount() const
+{
+	ApiCall call(m_profiler, "GetWarpGateCount");
+	return m_observation->GetWarpGateCount();
+}
+
+int32_t CountingObservation::GetLarvaCount() const
+{
+	ApiCall call(m_profiler, "GetLarvaCount");
+	return m_observation->GetLarvaCount();
+}
+
+sc2::Point2D CountingObservation::GetCameraPos() const
+{
+	ApiCall call(m_profiler, "GetCameraPos");
+	return m_observation->GetCameraPos();
+}
+
+sc2::Point3D CountingObservation::GetStartLocation() const
+{
+	ApiCall call(m_profiler, "GetStartLocation");
+	return m_observation->GetStartLocation();
+}
+
+const std::vector<sc2::PlayerResult> & CountingObservation::GetResults() const
+{
+	ApiCall call(m_profiler, "GetResults");
+	return m_observation->GetResults();
+}
+
+bool CountingObservation::HasCreep(const sc2::Point2D & point) const
+{
+	ApiCall call(m_profiler, "HasCreep");
+	return m_observation->HasCreep(point);
+}
+
+sc2::Visibility CountingObservation::GetVisibility(const sc2::Point2D & point) const
+{
+	ApiCall call(m_profiler, "GetVisibility");
+	return m_observation->GetVisibility(point);
+}
+
+bool CountingObservation::IsPathable(const sc2::Point2D & point) const
+{
+	ApiCall call(m_profiler, "IsPathable");
+	return m_observation->IsPathable(point);
+}
+
+bool CountingObservation::IsPlacable(const sc2::Point2D & point) const
+{
+	ApiCall call(m_profiler, "IsPlacable");
+	return m_observation->IsPlacable(point);
+}
+
+float CountingObservation::TerrainHeight(const sc2::Point2D & point) const
+{
+	ApiCall call(m_profiler, "TerrainHeight");
+	return m_observation->TerrainHeight(point);
+}
+
+const SC2APIProtocol::Observation * CountingObservation::GetRawObservation() const
+{
+	ApiCall call(m_profiler, "GetRawObservation");
+	return m_observation->GetRawObservation();
+}
+
+CountingQuery::CountingQuery(ApiProfiler & profiler)
+	: m_profiler(profiler)
+	, m_query(nullptr)
+{
+
+}
+
+void CountingQuery::setQuery(sc2::QueryInterface * query)
+{
+	m_query = query;
+}
+
+sc2::AvailableAbilities CountingQuery::GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements)
+{
+	ApiCall call(m_profiler, "Query GetAbilitiesForUnit");
+	return m_query->GetAbilitiesForUnit(unit, ignore_resource_requirements);
+}
+
+std::vector<sc2::AvailableAbilities> CountingQuery::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	ApiCall call(m_profiler, "Query GetAbilitiesForUnits");
+	std::vector<sc2::AvailableAbilities> abilities = m_query->GetAbilitiesForUnits(units, ignore_resource_requirements);
+	call.setElements(abilities.size());
+	return abilities;
+}
+
+float CountingQuery::PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end)
+{
+	ApiCall call(m_profiler, "Query PathingDistance");
+	return m_query->PathingDistance(start, end);
+}
+
+float CountingQuery::PathingDistance(const sc2::Unit * start, const sc2::Point2D & end)
+{
+	ApiCall call(m_profiler, "Query PathingDistance");
+	return m_query->PathingDistance(start, end);
+}
+
+std::vector<float> CountingQuery::PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries)
+{
+	ApiCall call(m_profiler, "Query PathingDistance");
+	std::vector<float> distances = m_query->PathingDistance(queries);
+	call.setElements(distances.size());
+	return distances;
+}
+
+bool CountingQuery::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit)
+{
+	ApiCall call(m_profiler, "Query Placement");
+	return m_query->Placement(ability, target_pos, unit);
+}
+
+std::vector<bool> CountingQuery::Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries)
+{
+	ApiCall call(m_profiler, "Query Placement");
+	std::vector<bool> placeable = m_query->Placement(queries);
+	call.setElements(placeable.size());
+	return placeable;
+}
+
+ApiProfiler::ApiProfiler()
+	: m_enabled(false)
+	, m_steps(0)
+	, m_lastCalls(0)
+	, m_lastMs(0.0)
+	, m_observation(*this)
+	, m_query(*this)
+{
+
+}
+
+void ApiProfiler::start(const sc2::ObservationInterface * observation, sc2::QueryInterface * query)
+{
+	m_observation.setObservation(observation);
+	m_query.setQuery(query);
+	m_enabled = true;
+}
+
+bool ApiProfiler::isEnabled() const
+{
+	return m_enabled;
+}
+
+const sc2::ObservationInterface * ApiProfiler::getObservation() const
+{
+	return &m_observation;
+}
+
+sc2::QueryInterface * ApiProfiler::getQuery()
+{
+	return &m_query;
+}
+
+void ApiProfiler::record(const char * function, double ms, size_t elements)
+{
+	const std::string & zone = ModuleProfiler::currentZone();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ApiCallSite & site = m_sites[std::make_pair(zone.empty() ? "Other" : zone, std::string(function))];
+	++site.stepCalls;
+	site.stepMs += ms;
+	site.stepElements += elements;
+}
+
+void ApiProfiler::onFrame()
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_lastCalls = 0;
+	m_lastMs = 0.0;
+	for (auto & site : m_sites)
+	{
+		m_lastCalls += site.second.stepCalls;
+		m_lastMs += site.second.stepMs;
+		site.second.addStep();
+	}
+	++m_steps;
+}
+
+size_t ApiProfiler::getLastCalls() const
+{
+	return m_lastCalls;
+}
+
+double ApiProfiler::getLastMs() const
+{
+	return m_lastMs;
+}
+
+size_t ApiProfiler::getSteps() const
+{
+	return m_steps;
+}
+
+std::vector<std::pair<std::pair<std::string, std::string>, ApiCallSite>> ApiProfiler::getSites() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::vector<std::pair<std::pair<std::string, std::string>, ApiCallSite>> sites(m_sites.begin(), m_sites.end());
+	lock.unlock();
+	std::sort(sites.begin(), sites.end(), [](const std::pair<std::pair<std::string, std::string>, ApiCallSite> & a, const std::pair<std::pair<std::string, std::string>, ApiCallSite> & b)
+	{
+		return a.second.totalMs > b.second.totalMs;
+	});
+	return sites;
+}
+
+void ApiProfiler::writeTable(std::ostream & out, size_t count) const
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+	const auto sites = getSites();
+	const double steps = static_cast<double>(std::max<size_t>(1, m_steps));
+	const std::ios::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(2);
+	out << "API calls, last step " << m_lastCalls << " in " << m_lastMs << " ms\n";
+	out << "Call site: calls/step ms/step max ms/step elements/step\n";
+	for (size_t i = 0; i < sites.size() && i < count; ++i)
+	{
+		const ApiCallSite & site = sites[i].second;
+		out << "  " << sites[i].first.second << " in " << sites[i].first.first << ": " << site.calls / steps << " " << site.totalMs / steps
+			<< " " << site.maxMs << " " << site.elements / steps << "\n";
+	}
+	out.flags(flags);
+	out.precision(precision);
+}
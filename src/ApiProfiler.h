@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Common.h"
+#include "Timer.hpp"
+#include <mutex>
+
+class ApiProfiler;
+
+// the calls of one API function from one zone, over the game and in the current step
+struct ApiCallSite
+{
+	size_t	calls;
+	double	totalMs;
+	double	maxMs;
+	size_t	elements;
+	size_t	stepCalls;
+	double	stepMs;
+	size_t	stepElements;
+
+	ApiCallSite();
+
+	void	addStep();
+};
+
+// times one call to the game's interfaces. The zone of the calling thread is its call site.
+// Elements are the size of what the call returns by value, 1 for anything else.
+class ApiCall
+{
+	ApiProfiler *	m_profiler;
+	const char *	m_function;
+	size_t			m_elements;
+	Timer			m_timer;
+
+public:
+
+	ApiCall(ApiProfiler & profiler, const char * function);
+	~ApiCall();
+
+	void	setElements(size_t elements);
+
+	ApiCall(const ApiCall &) = delete;
+	ApiCall & operator=(const ApiCall &) = delete;
+};
+
+// passes every call on to the observation of the game and counts it
+class CountingObservation : public sc2::ObservationInterface
+{
+	ApiProfiler &						m_profiler;
+	const sc2::ObservationInterface *	m_observation;
+
+public:
+
+	CountingObservation(ApiProfiler & profiler);
+
+	void	setObservation(const sc2::ObservationInterface * observation);
+
+	uint32_t	GetPlayerID() const override;
+	uint32_t	GetGameLoop() const override;
+	sc2::Units	GetUnits() const override;
+	sc2::Units	GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter = {}) const override;
+	sc2::Units	GetUnits(sc2::Filter filter) const override;
+	const sc2::Unit *	GetUnit(sc2::Tag tag) const override;
+	const sc2::RawActions &	GetRawActions() const override;
+	const sc2::SpatialActions &	GetFeatureLayerActions() const override;
+	const sc2::SpatialActions &	GetRenderedActions() const override;
+	const std::vector<sc2::ChatMessage> &	GetChatMessages() const override;
+	const std::vector<sc2::PowerSource> &	GetPowerSources() const override;
+	const std::vector<sc2::Effect> &	GetEffects() const override;
+	const std::vector<sc2::UpgradeID> &	GetUpgrades() const override;
+	const sc2::Score &	GetScore() const override;
+	const sc2::Abilities &	GetAbilityData(bool force_refresh = false) const override;
+	const sc2::UnitTypes &	GetUnitTypeData(bool force_refresh = false) const override;
+	const sc2::Upgrades &	GetUpgradeData(bool force_refresh = false) const override;
+	const sc2::Buffs &	GetBuffData(bool force_refresh = false) const override;
+	const sc2::Effects &	GetEffectData(bool force_refresh = false) const override;
+	const sc2::GameInfo &	GetGameInfo() const override;
+	int32_t		GetMinerals() const override;
+	int32_t		GetVespene() const override;
+	int32_t		GetFoodCap() const override;
+	int32_t		GetFoodUsed() const override;
+	int32_t		GetFoodArmy() const override;
+	int32_t		GetFoodWorkers() const override;
+	int32_t		GetIdleWorkerCount() const override;
+	int32_t		GetArmyCount() const override;
+	int32_t		GetWarpGateCount() const override;
+	int32_t		GetLarvaCount() const override;
+	sc2::Point2D	GetCameraPos() const override;
+	sc2::Point3D	GetStartLocation() const override;
+	const std::vector<sc2::PlayerResult> &	GetResults() const override;
+	bool		HasCreep(const sc2::Point2D & point) const override;
+	sc2::Visibility	GetVisibility(const sc2::Point2D & point) const override;
+	bool		IsPathable(const sc2::Point2D & point) const override;
+	bool		IsPlacable(const sc2::Point2D & point) const override;
+	float		TerrainHeight(const sc2::Point2D & point) const override;
+	const SC2APIProtocol::Observation *	GetRawObservation() const override;
+};
+
+// passes every query on to the game and counts it
+class CountingQuery : public sc2::QueryInterface
+{
+	ApiProfiler &			m_profiler;
+	sc2::QueryInterface *	m_query;
+
+public:
+
+	CountingQuery(ApiProfiler & profiler);
+
+	void	setQuery(sc2::QueryInterface * query);
+
+	sc2::AvailableAbilities	GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities>	GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	float		PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end) override;
+	float		PathingDistance(const sc2::Unit * start, const sc2::Point2D & end) override;
+	std::vector<float>	PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries) override;
+	bool		Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+	std::vector<bool>	Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries) override;
+};
+
+// counts the calls to the observation, query and debug interfaces per call site when ProfileApiCalls is set: how often,
+// how long they took and how many elements they returned. The bot then goes through the counting stand-ins, the drawing
+// and SendDebug count themselves. The ModuleProfiler closes the steps and shows the worst call sites with its zones.
+class ApiProfiler
+{
+	bool				m_enabled;
+	std::map<std::pair<std::string, std::string>, ApiCallSite>	m_sites;	// by zone and function
+	mutable std::mutex	m_mutex;
+	size_t				m_steps;
+	size_t				m_lastCalls;	// of all call sites in the last step
+	double				m_lastMs;
+	CountingObservation	m_observation;
+	CountingQuery		m_query;
+
+public:
+
+	ApiProfiler();
+
+	// counts the calls to these from now on, they are what the bot used so far
+	void	start(const sc2::ObservationInterface * observation, sc2::QueryInterface * query);
+	bool	isEnabled() const;
+	const sc2::ObservationInterface *	getObservation() const;
+	sc2::QueryInterface *	getQuery();
+
+	void	record(const char * function, double ms, size_t elements);
+	// closes the last step
+	void	onFrame();
+	size_t	getLastCalls() const;
+	double	getLastMs() const;
+	size_t	getSteps() const;
+	// by zone and function, the ones that took the most time first
+	std::vector<std::pair<std::pair<std::string, std::string>, ApiCallSite>>	getSites() const;
+	// the count call sites that took the most time, per step over the game
+	void	writeTable(std::ostream & out, size_t count) const;
+};
@@ -2,6 +2,7 @@
 #include "CameraModule.h"
 #include "sc2api/sc2_proto_interface.h"
 #include <iostream>
+#include <algorithm>
 
 //Radius to detect groups of army units
 const float armyBlobRadius = 10.0f;
@@ -55,11 +56,12 @@ void CameraModule::onFrame()
 	if (!m_initialized)
 	{
 		onStart();
+		m_underAttack.clear();
 		return;
 	}
 	moveCameraFallingNuke();
 	moveCameraNukeDetect();
-	//moveCameraIsUnderAttack();
+	moveCameraIsUnderAttack();
 	moveCameraIsAttacking();
 	if (m_client->Observation()->GetGameLoop() <= watchScoutWorkerUntil)
 	{
@@ -108,18 +110,14 @@ void CameraModule::moveCameraNukeDetect()
 void CameraModule::moveCameraIsUnderAttack()
 {
 	const int prio = 4;
-	if (!shouldMoveCamera(prio))
-	{
-		return;
-	}
-
-	for (auto & unit : m_client->Observation()->GetUnits())
+	if (shouldMoveCamera(prio))
 	{
-		if (isUnderAttack(unit))
+		for (auto & unit : m_underAttack)
 		{
 			moveCamera(unit, prio);
 		}
 	}
+	m_underAttack.clear();
 }
 
 
@@ -250,6 +248,14 @@ void CameraModule::moveCameraUnitCreated(const sc2::Unit * unit)
 	}
 }
 
+void CameraModule::onUnitDamaged(const sc2::Unit * unit)
+{
+	if (!isUnderAttack(unit))
+	{
+		m_underAttack.push_back(unit);
+	}
+}
+
 const bool CameraModule::shouldMoveCamera(const int priority) const
 {
 	const int elapsedFrames = m_client->Observation()->GetGameLoop() - lastMoved;
@@ -327,10 +333,10 @@ void CameraModule::updateCameraPosition()
 
 //Utility
 
-//At the moment there is no flag for being under attack
+//There is no flag for being under attack. The bot has to tell us via onUnitDamaged.
 const bool CameraModule::isUnderAttack(const sc2::Unit * unit) const
 {
-	return false;
+	return std::find(m_underAttack.begin(), m_underAttack.end(), unit) != m_underAttack.end();
 }
 
 const bool CameraModule::isAttacking(const sc2::Unit * attacker) const
@@ -24,6 +24,7 @@ protected:
 	sc2::Point2D cameraFocusPosition;
 	const sc2::Unit *  cameraFocusUnit;
 	bool followUnit;
+	std::vector<const sc2::Unit *> m_underAttack;
 
 	void moveCamera(const sc2::Point2D pos, const int priority);
 	void moveCamera(const sc2::Unit * unit, int priority);
@@ -59,6 +60,7 @@ public:
 	void onStart();
 	void onFrame();
 	void moveCameraUnitCreated(const sc2::Unit * unit);
+	void onUnitDamaged(const sc2::Unit * unit);
 
 	~CameraModule();
 };
@@ -69,7 +69,7 @@ BaseLocation::BaseLocation(CCBot & bot, int baseID, const std::vector<const sc2:
 
 	// compute this BaseLocation's DistanceMap, which will compute the ground distance
 	// from the center of its recourses to every other tile on the map
-	m_distanceMap = m_bot.Map().getDistanceMap(m_centerOfResources);
+	m_distanceMap = *m_bot.Map().getDistanceMap(m_centerOfResources);
 
 	// check to see if this is a start location for the map
 	for (const auto & pos : m_bot.Observation()->GetGameInfo().enemy_start_locations)
@@ -14,7 +14,6 @@ void BaseLocationManager::onStart()
 {
 	//sc2::search::CalculateExpansionLocations(m_bot.Observation(),m_bot.Query())
 
-	m_tileBaseLocations = std::vector<std::vector<BaseLocation *>>(m_bot.Map().width(), std::vector<BaseLocation *>(m_bot.Map().height(), nullptr));
 	m_playerStartingBaseLocations[Players::Self]  = nullptr;
 	m_playerStartingBaseLocations[Players::Enemy] = nullptr; 
 	
@@ -113,7 +112,19 @@ void BaseLocationManager::onStart()
 		}
 	}
 
-	// construct the map of tile positions to base locations
+	computeTileBaseLocations();
+
+	// construct the sets of occupied base locations
+	m_occupiedBaseLocations[Players::Self] = std::set<const BaseLocation *>();
+	m_occupiedBaseLocations[Players::Enemy] = std::set<const BaseLocation *>();
+
+	//We know at least one of our 
+}
+
+// construct the map of tile positions to base locations
+void BaseLocationManager::computeTileBaseLocations()
+{
+	m_tileBaseLocations = std::vector<std::vector<BaseLocation *>>(m_bot.Map().width(), std::vector<BaseLocation *>(m_bot.Map().height(), nullptr));
 	for (float x=0; x < m_bot.Map().width(); ++x)
 	{
 		for (int y=0; y < m_bot.Map().height(); ++y)
@@ -131,12 +142,6 @@ void BaseLocationManager::onStart()
 			}
 		}
 	}
-
-	// construct the sets of occupied base locations
-	m_occupiedBaseLocations[Players::Self] = std::set<const BaseLocation *>();
-	m_occupiedBaseLocations[Players::Enemy] = std::set<const BaseLocation *>();
-
-	//We know at least one of our 
 }
 
 void BaseLocationManager::onFrame()
@@ -170,7 +175,7 @@ void BaseLocationManager::onFrame()
 			baseLocation->setPlayerOccupying(Players::Enemy, true);
 		}
 	}
-	for (const auto & unit : m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self))
+	for (const auto & unit : m_bot.UnitInfo().getUnits(Players::Self))
 	{
 		// we only care about buildings on the ground
 		if (!m_bot.Data(unit->unit_type).isBuilding || unit->is_flying || !unit->is_alive)
@@ -328,7 +333,7 @@ const sc2::Point2D BaseLocationManager::getRallyPoint() const
 	//GET NEWEST EXPANSION
 	sc2::Point2D fixpoint = getNewestExpansion(Players::Self);
 	//Or bunker
-	const sc2::Units bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_BUNKER));
+	const UnitSpan bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 
 	std::vector<const BaseLocation *> startingBases = getStartingBaseLocations();
 	sc2::Point2D targetPos(0.0f, 0.0f);
@@ -354,8 +359,8 @@ const sc2::Point2D BaseLocationManager::getRallyPoint() const
 	const sc2::Point2D rallyPoint = fixpoint + Util::normalizeVector(targetPos - fixpoint, 5.0f);
 
 	// get the precomputed vector of tile positions which are sorted closes to this location
-	auto & closestTorallyPoint = m_bot.Map().getClosestTilesTo(rallyPoint);
-	for (const auto & pos : m_bot.Map().getClosestTilesTo(rallyPoint))
+	const auto closestTorallyPoint = m_bot.Map().getClosestTilesTo(rallyPoint);
+	for (const auto & pos : *closestTorallyPoint)
 	{
 		if (m_bot.Map().isWalkable(pos))
 		{
@@ -375,6 +380,7 @@ sc2::Point2D BaseLocationManager::getNextExpansion(int player) const
 	{
 		return sc2::Point2D(0.0f, 0.0f);
 	}
+	std::vector<const BaseLocation *> candidates;
 	for (const auto & base : getBaseLocations())
 	{
 		// skip mineral only and starting locations (TODO: fix this)
@@ -382,7 +388,20 @@ sc2::Point2D BaseLocationManager::getNextExpansion(int player) const
 		{
 			continue;
 		}
-
+		candidates.push_back(base);
+		m_bot.Pathing().request(homeBase->getBasePosition(), base->getBasePosition());
+	}
+	// one metric for all bases: the engine's distances if it found a path to every base, our own map otherwise
+	std::vector<float> pathingDistances;
+	bool usePathing = true;
+	for (const auto & base : candidates)
+	{
+		pathingDistances.push_back(m_bot.Pathing().getDistance(homeBase->getBasePosition(), base->getBasePosition()));
+		usePathing = usePathing && pathingDistances.back() >= 0.0f;
+	}
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		const BaseLocation * base = candidates[i];
 		// get the tile position of the base
 		auto tile = base->getDepotPosition();
 		
@@ -394,7 +413,7 @@ sc2::Point2D BaseLocationManager::getNextExpansion(int player) const
 		}
 
 		// the base's distance from our main nexus
-		int distanceFromHome = homeBase->getGroundDistance(tile);
+		int distanceFromHome = usePathing ? static_cast<int>(pathingDistances[i]) : homeBase->getGroundDistance(tile);
 
 		// if it is not connected, continue
 		if (distanceFromHome < 0)
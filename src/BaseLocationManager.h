@@ -23,6 +23,8 @@ public:
 	void onStart();
 	void onFrame();
 	void drawBaseLocations();
+	// which base location every tile belongs to, onStart does it. Public for the micro benchmarks
+	void computeTileBaseLocations();
 
 	const std::vector<const BaseLocation *> & getBaseLocations() const;
 	BaseLocation * getBaseLocation(const sc2::Point2D & pos) const;
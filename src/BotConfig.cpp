@@ -27,6 +27,12 @@ BotConfig::BotConfig()
 	DrawResourceInfo					= false;
 	DrawWorkerInfo					  = false;
 	DrawModuleTimers					= false;
+	WriteProfile						= false;
+	WriteTrace						  = false;
+	TraceSlowStepMs					 = 85;
+	RecordObservations				  = false;
+	ProfileApiCalls					 = false;
+	TrackAllocations					= false;
 	DrawReservedBuildingTiles		   = false;
 	DrawBuildingInfo					= false;
 	DrawEnemyUnitInfo				   = false;
@@ -35,6 +41,7 @@ BotConfig::BotConfig()
 	DrawSquadInfo					   = false;
 
 	KiteWithRangedUnits				 = true;
+	ParallelSquadMicro				  = true;
 	ScoutHarassEnemy					= true;
 	CombatUnitsForAttack				= 50;
 
@@ -46,6 +53,11 @@ BotConfig::BotConfig()
 	WorkersPerRefinery				  = 3;
 	BuildingSpacing					 = 0;
 	PylonSpacing						= 3;
+
+	MaxActionsPerStep				   = 60;
+	MaxActionDelay					  = 22;
+	StepTimeBudget					  = 20;
+	PipelineSteps					   = false;
 }
 
 void BotConfig::readConfigFile()
@@ -92,6 +104,7 @@ void BotConfig::readConfigFile()
 	{
 		const rapidjson::Value & micro = doc["Micro"];
 		JSONTools::ReadBool("KiteWithRangedUnits", micro, KiteWithRangedUnits);
+		JSONTools::ReadBool("ParallelSquadMicro", micro, ParallelSquadMicro);
 		JSONTools::ReadBool("ScoutHarassEnemy", micro, ScoutHarassEnemy);
 		JSONTools::ReadInt("CombatUnitsForAttack", micro, CombatUnitsForAttack);
 	}
@@ -105,6 +118,16 @@ void BotConfig::readConfigFile()
 		JSONTools::ReadInt("WorkersPerRefinery", macro, WorkersPerRefinery);
 	}
 
+	// Parse the Action Options
+	if (doc.HasMember("Actions") && doc["Actions"].IsObject())
+	{
+		const rapidjson::Value & actions = doc["Actions"];
+		JSONTools::ReadInt("MaxActionsPerStep", actions, MaxActionsPerStep);
+		JSONTools::ReadInt("MaxActionDelay", actions, MaxActionDelay);
+		JSONTools::ReadInt("StepTimeBudget", actions, StepTimeBudget);
+		JSONTools::ReadBool("PipelineSteps", actions, PipelineSteps);
+	}
+
 	// Parse the Debug Options
 	if (doc.HasMember("Debug") && doc["Debug"].IsObject())
 	{
@@ -120,6 +143,12 @@ void BotConfig::readConfigFile()
 		JSONTools::ReadBool("DrawSquadInfo",			debug, DrawSquadInfo);
 		JSONTools::ReadBool("DrawBuildingInfo",		 debug, DrawBuildingInfo);
 		JSONTools::ReadBool("DrawModuleTimers",		 debug, DrawModuleTimers);
+		JSONTools::ReadBool("WriteProfile",			 debug, WriteProfile);
+		JSONTools::ReadBool("WriteTrace",			   debug, WriteTrace);
+		JSONTools::ReadInt("TraceSlowStepMs",		 debug, TraceSlowStepMs);
+		JSONTools::ReadBool("RecordObservations",	 debug, RecordObservations);
+		JSONTools::ReadBool("ProfileApiCalls",		  debug, ProfileApiCalls);
+		JSONTools::ReadBool("TrackAllocations",		 debug, TrackAllocations);
 		JSONTools::ReadBool("DrawEnemyUnitInfo",		debug, DrawEnemyUnitInfo);
 		JSONTools::ReadBool("DrawLastSeenTileInfo",	 debug, DrawLastSeenTileInfo);
 		JSONTools::ReadBool("DrawUnitTargetInfo",	   debug, DrawUnitTargetInfo);
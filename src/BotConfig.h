@@ -35,6 +35,12 @@ public:
 	bool DrawScoutInfo;
 	bool DrawWorkerInfo;
 	bool DrawModuleTimers;
+	bool WriteProfile;
+	bool WriteTrace;
+	int TraceSlowStepMs;
+	bool RecordObservations;
+	bool ProfileApiCalls;
+	bool TrackAllocations;
 	bool DrawReservedBuildingTiles;
 	bool DrawBuildingInfo;
 	bool DrawEnemyUnitInfo;
@@ -48,12 +54,18 @@ public:
 	sc2::Color ColorUnitNotNearEnemy;
 	
 	bool KiteWithRangedUnits;	
+	bool ParallelSquadMicro;
 	bool ScoutHarassEnemy;
 	int CombatUnitsForAttack;
 	
 	int WorkersPerRefinery;
 	int BuildingSpacing;
 	int PylonSpacing;
+
+	int MaxActionsPerStep;
+	int MaxActionDelay;
+	int StepTimeBudget;
+	bool PipelineSteps;
  
 	BotConfig();
 
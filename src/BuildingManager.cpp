@@ -23,6 +23,12 @@ void BuildingManager::onStart()
 	m_buildingPlacer.onStart();
 }
 
+// every step, also when the production task does not run
+void BuildingManager::onUnitDeltas(const UnitDeltas & deltas)
+{
+	m_buildingPlacer.onUnitDeltas(deltas);
+}
+
 // gets called every frame from GameCommander
 void BuildingManager::onFrame()
 {
@@ -132,14 +138,7 @@ void BuildingManager::assignWorkersToUnassignedBuildings()
 		}
 
 		// reserve this building's space
-		if (b.type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || b.type == sc2::UNIT_TYPEID::TERRAN_FACTORY || b.type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
-		{
-			m_buildingPlacer.reserveTiles((int)b.finalPosition.x, (int)b.finalPosition.y, Util::GetUnitTypeWidth(b.type, m_bot)+2, Util::GetUnitTypeHeight(b.type, m_bot));
-		}
-		else
-		{
-			m_buildingPlacer.reserveTiles((int)b.finalPosition.x, (int)b.finalPosition.y, Util::GetUnitTypeWidth(b.type, m_bot), Util::GetUnitTypeHeight(b.type, m_bot));
-		}
+		m_buildingPlacer.reserveTiles(b);
 
 		b.status = BuildingStatus::Assigned;
 	}
@@ -235,7 +234,20 @@ void BuildingManager::constructAssignedBuildings()
 				// if it's not a refinery, we build right on the position
 				else
 				{
-					if (m_bot.Query()->Placement(m_bot.Data(b.type).buildAbility, b.finalPosition))
+					// running ahead, the game answers for the spot in the next step and we give the command after that
+					if (m_bot.Scheduler().isRunningAhead())
+					{
+						const BuildingPlacer::PlacementState placement = m_buildingPlacer.getPlacement(b.type, b.finalPosition);
+						if (placement == BuildingPlacer::Unknown)
+						{
+							continue;
+						}
+						if (placement == BuildingPlacer::Placeable)
+						{
+							Micro::SmartBuild(b.builderUnit, b.type, b.finalPosition, m_bot);
+						}
+					}
+					else if (m_bot.Query()->Placement(m_bot.Data(b.type).buildAbility, b.finalPosition))
 					{
 						Micro::SmartBuild(b.builderUnit, b.type, b.finalPosition, m_bot);
 
@@ -327,7 +339,7 @@ void BuildingManager::checkForStartedConstruction()
 					m_bot.requestGuards(false);
 				}
 				// free this space
-				m_buildingPlacer.freeTiles((int)b.finalPosition.x, (int)b.finalPosition.y, Util::GetUnitTypeWidth(b.type, m_bot), Util::GetUnitTypeHeight(b.type, m_bot));
+				m_buildingPlacer.freeTiles(b);
 
 				// only one building will match
 				break;
@@ -592,7 +604,7 @@ void BuildingManager::removeBuildings(const std::vector<Building> & toRemove)
 			{
 				m_bot.Workers().finishedWithWorker(b.builderUnit);
 			}
-			m_buildingPlacer.freeTiles((int)b.finalPosition.x, (int)b.finalPosition.y, Util::GetUnitTypeWidth(b.type, m_bot), Util::GetUnitTypeHeight(b.type, m_bot));
+			m_buildingPlacer.freeTiles(b);
 			m_buildings.erase(it);
 		}
 	}
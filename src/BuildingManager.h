@@ -4,6 +4,7 @@
 #include "BuildingPlacer.h"
 
 class CCBot;
+struct UnitDeltas;
 
 class BuildingManager
 {
@@ -37,6 +38,7 @@ public:
 
 	void				onStart();
 	void				onFrame();
+	void				onUnitDeltas(const UnitDeltas & deltas);
 	void reservedResourcesCheck();
 	void				addBuildingTask(const sc2::UnitTypeID & type, const sc2::Point2D & desiredPosition);
 	void				drawBuildingInformation();
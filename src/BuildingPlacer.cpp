@@ -5,8 +5,19 @@
 #include "Util.h"
 #include "Drawing.h"
 
+namespace
+{
+	// buildings are placed by their center, as the game takes the position of a build command. Odd footprints snap to the tile center,
+	// so the footprint starts at center - size / 2
+	int footprintStart(int center, int size)
+	{
+		return center - size / 2;
+	}
+}
+
 BuildingPlacer::BuildingPlacer(CCBot & bot)
 	: m_bot(bot)
+	, m_occupancyDirty(true)
 {
 
 }
@@ -14,9 +25,11 @@ BuildingPlacer::BuildingPlacer(CCBot & bot)
 void BuildingPlacer::onStart()
 {
 	m_reserveMap = std::vector< std::vector<bool> >(m_bot.Map().width(), std::vector<bool>(m_bot.Map().height(), false));
+	m_occupied = std::vector< std::vector<bool> >(m_bot.Map().width(), std::vector<bool>(m_bot.Map().height(), false));
+	m_occupancyDirty = true;
 	
 	sc2::Point2D buildingSeedPosition = m_bot.Bases().getBuildingLocation();
-	const std::vector<sc2::Point2D> closestToBuilding = m_bot.Map().getClosestTilesTo(buildingSeedPosition);
+	const std::vector<sc2::Point2D> closestToBuilding = *m_bot.Map().getClosestTilesTo(buildingSeedPosition);
 	buildingPlace depots(buildingSeedPosition,4,Building(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT,sc2::Point2D()), closestToBuilding);
 	buildingPlace production(buildingSeedPosition, 9, Building(sc2::UNIT_TYPEID::TERRAN_BARRACKS, sc2::Point2D()), closestToBuilding);
 	m_buildLocationTester.push_back(depots);
@@ -25,9 +38,202 @@ void BuildingPlacer::onStart()
 
 void BuildingPlacer::onFrame()
 {
+	ProfileScope profile(m_bot.Profiler(), "BuildingPlacer");
+	updatePlacementCache();
 	expandBuildingTesterOnce();
 }
 
+// placement only changes if a building appears, vanishes, lands or lifts off
+void BuildingPlacer::onUnitDeltas(const UnitDeltas & deltas)
+{
+	for (const sc2::Units * units : { &deltas.created, &deltas.destroyed, &deltas.enteredVision, &deltas.leftVision, &deltas.morphed })
+	{
+		for (const auto & unit : *units)
+		{
+			if (Util::IsBuildingType(unit->unit_type, m_bot))
+			{
+				m_placementCache.clear();
+				m_occupancyDirty = true;
+				return;
+			}
+		}
+	}
+}
+
+void BuildingPlacer::updatePlacementCache()
+{
+	if (m_occupancyDirty)
+	{
+		updateOccupancy();
+	}
+}
+
+// stamps the footprints of all structures and resources we know of
+void BuildingPlacer::updateOccupancy()
+{
+	m_occupancyDirty = false;
+	for (auto & column : m_occupied)
+	{
+		std::fill(column.begin(), column.end(), false);
+	}
+	for (const auto & unit : m_bot.Observation()->GetUnits())
+	{
+		int width, height;
+		if (Util::IsMineral(unit))
+		{
+			width = 2;
+			height = 1;
+		}
+		else if (Util::IsGeyser(unit))
+		{
+			width = 3;
+			height = 3;
+		}
+		else if (Util::IsBuildingType(unit->unit_type, m_bot) && !unit->is_flying)
+		{
+			width = getFootprintSize(unit);
+			height = width;
+		}
+		else
+		{
+			continue;
+		}
+		const int ox = static_cast<int>(std::round(unit->pos.x - width / 2.0f));
+		const int oy = static_cast<int>(std::round(unit->pos.y - height / 2.0f));
+		for (int x = ox; x < ox + width; ++x)
+		{
+			for (int y = oy; y < oy + height; ++y)
+			{
+				if (m_bot.Map().isValid(x, y))
+				{
+					m_occupied[x][y] = true;
+				}
+			}
+		}
+	}
+}
+
+int BuildingPlacer::getFootprintSize(const sc2::Unit * unit) const
+{
+	// the build ability only exists for the types our tech tree knows
+	if (m_bot.Data(unit->unit_type).buildAbility != sc2::ABILITY_ID::INVALID)
+	{
+		return Util::GetUnitTypeWidth(unit->unit_type, m_bot);
+	}
+	return static_cast<int>(2 * unit->radius);
+}
+
+// the placement rules of the game without asking it: placement grid, structures and resources,
+// creep, the no-build zone of town halls around resources and the space for the addon.
+// Refineries only go on geysers, the game has to decide those.
+bool BuildingPlacer::canPlaceLocally(sc2::UnitTypeID type, int x, int y, bool withAddon) const
+{
+	if (Util::IsRefineryType(type))
+	{
+		return true;
+	}
+	const int width = Util::GetUnitTypeWidth(type, m_bot);
+	const int height = Util::GetUnitTypeHeight(type, m_bot);
+	const int ox = footprintStart(x, width);
+	const int oy = footprintStart(y, height);
+	const bool isTownHall = Util::IsTownHallType(type);
+	for (int tx = ox; tx < ox + width; ++tx)
+	{
+		for (int ty = oy; ty < oy + height; ++ty)
+		{
+			if (!isPlaceableTile(tx, ty) || (isTownHall && m_bot.Map().isNearResources(tx, ty)))
+			{
+				return false;
+			}
+		}
+	}
+	if (withAddon && (type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || type == sc2::UNIT_TYPEID::TERRAN_FACTORY || type == sc2::UNIT_TYPEID::TERRAN_STARPORT))
+	{
+		// the 2x2 addon sits right of the building, aligned with its bottom
+		for (int tx = ox + width; tx < ox + width + 2; ++tx)
+		{
+			for (int ty = oy; ty < oy + 2; ++ty)
+			{
+				if (!isPlaceableTile(tx, ty))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool BuildingPlacer::isPlaceableTile(int x, int y) const
+{
+	return m_bot.Map().isBuildable(x, y) && !m_occupied[x][y] && !m_bot.Observation()->HasCreep(sc2::Point2D(x + 0.5f, y + 0.5f));
+}
+
+std::vector<char> & BuildingPlacer::getPlacementCache(sc2::UnitTypeID type) const
+{
+	std::vector<char> & cache = m_placementCache[static_cast<uint32_t>(type)];
+	if (cache.empty())
+	{
+		cache.resize(m_bot.Map().width() * m_bot.Map().height(), Unknown);
+	}
+	return cache;
+}
+
+BuildingPlacer::PlacementState BuildingPlacer::getPlacement(sc2::UnitTypeID type, const sc2::Point2D & pos)
+{
+	const int x = static_cast<int>(pos.x);
+	const int y = static_cast<int>(pos.y);
+	if (!m_bot.Map().isValid(x, y))
+	{
+		return Blocked;
+	}
+	char & placement = getPlacementCache(type)[x * m_bot.Map().height() + y];
+	if (placement != Unknown)
+	{
+		return static_cast<PlacementState>(placement);
+	}
+	if (m_bot.Scheduler().isRunningAhead())
+	{
+		if (m_deferredPlacements.empty())
+		{
+			m_bot.Scheduler().deferQuery([this]() { resolveDeferredPlacements(); });
+		}
+		m_deferredPlacements.push_back(std::make_pair(type, pos));
+		return Unknown;
+	}
+	ProfileScope query(m_bot.Profiler(), "Query Placement", "api");
+	placement = m_bot.Query()->Placement(m_bot.Data(type).buildAbility, pos) ? Placeable : Blocked;
+	return static_cast<PlacementState>(placement);
+}
+
+// one query for everything asked while running ahead. onUnitDeltas already dropped what the buildings of this step changed.
+void BuildingPlacer::resolveDeferredPlacements()
+{
+	std::vector<sc2::QueryInterface::PlacementQuery> queries;
+	for (const auto & deferred : m_deferredPlacements)
+	{
+		queries.push_back(sc2::QueryInterface::PlacementQuery(m_bot.Data(deferred.first).buildAbility, deferred.second));
+	}
+	std::vector<bool> results;
+	{
+		ProfileScope query(m_bot.Profiler(), "Query Placement", "api");
+		results = m_bot.Query()->Placement(queries);
+	}
+	for (size_t i = 0; i < m_deferredPlacements.size() && i < results.size(); ++i)
+	{
+		const sc2::Point2D & pos = m_deferredPlacements[i].second;
+		getPlacementCache(m_deferredPlacements[i].first)[static_cast<int>(pos.x) * m_bot.Map().height() + static_cast<int>(pos.y)] = results[i] ? Placeable : Blocked;
+	}
+	m_deferredPlacements.clear();
+}
+
+// the local rules do not know about units standing around, so the spot we pick is confirmed by the game once.
+// Running ahead we go with the local rules until the game answered
+bool BuildingPlacer::confirmPlacement(const Building & b, int x, int y)
+{
+	return getPlacement(b.type, sc2::Point2D(static_cast<float>(x), static_cast<float>(y))) != Blocked;
+}
+
 void BuildingPlacer::expandBuildingTesterOnce()
 {
 	for (auto & buildLocationTester : m_buildLocationTester)
@@ -42,9 +248,14 @@ void BuildingPlacer::expandBuildingTesterOnce()
 		{
 			continue;
 		}
+		if (static_cast<size_t>(buildLocationTester.m_idx) >= buildLocationTester.m_closestTiles.size())
+		{
+			continue;
+		}
 		sc2::Point2D pos = buildLocationTester.m_closestTiles[buildLocationTester.m_idx];
 
-		if (canBuildHereWithSpace((int)pos.x, (int)pos.y, buildLocationTester.m_building, m_bot.Config().BuildingSpacing))
+		if (canBuildHereWithSpace((int)pos.x, (int)pos.y, buildLocationTester.m_building, m_bot.Config().BuildingSpacing)
+			&& confirmPlacement(buildLocationTester.m_building, (int)pos.x, (int)pos.y))
 		{
 			buildLocationTester.m_canBuildHere = true;
 		}
@@ -71,9 +282,11 @@ bool BuildingPlacer::canBuildHere(int bx, int by, const Building & b) const
 	}
 
 	// check the reserve map
-	for (int x = bx; x < bx + Util::GetUnitTypeWidth(b.type, m_bot); x++)
+	const int width = Util::GetUnitTypeWidth(b.type, m_bot);
+	const int height = Util::GetUnitTypeHeight(b.type, m_bot);
+	for (int x = footprintStart(bx, width); x < footprintStart(bx, width) + width; x++)
 	{
-		for (int y = by; y < by + Util::GetUnitTypeHeight(b.type, m_bot); y++)
+		for (int y = footprintStart(by, height); y < footprintStart(by, height) + height; y++)
 		{
 			if (!m_bot.Map().isValid(x, y) || m_reserveMap[x][y])
 			{
@@ -88,7 +301,7 @@ bool BuildingPlacer::canBuildHere(int bx, int by, const Building & b) const
 		return false;
 	}
 	//Don't build below flying buildings
-	const sc2::Units flyingBuildings = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BARRACKSFLYING,sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING, sc2::UNIT_TYPEID::TERRAN_STARPORTFLYING }));
+	const UnitSpan flyingBuildings = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::FlyingBuilding);
 	sc2::Point2D loc(static_cast<float>(bx), static_cast<float>(by));
 	for (const auto & unit : flyingBuildings)
 	{
@@ -111,30 +324,16 @@ bool BuildingPlacer::canBuildHereWithSpace(int bx, int by, const Building & b, i
 		return false;
 	}
 
-	// height and width of the building
-	int width  = Util::GetUnitTypeWidth(b.type, m_bot);
-	int height = Util::GetUnitTypeHeight(b.type, m_bot);
-
-	// TODO: make sure we leave space for add-ons. These types of units can have addons:
-
-	// define the rectangle of the building spot
-	int startx = bx  + buildDist;
-	int starty = by + buildDist;
-	int endx   = bx + width + buildDist;
-	int endy   = by + height + buildDist;
-
-	if (b.type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || b.type == sc2::UNIT_TYPEID::TERRAN_FACTORY || b.type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
+	int startx, starty, endx, endy;
+	if (!getSpaceRect(bx, by, b, buildDist, startx, starty, endx, endy))
 	{
-		--startx;
-		endx += 2;
+		return false;
 	}
-	// if this rectangle doesn't fit on the map we can't build here
-	if (startx < 0 || starty < 0 || endx > m_bot.Map().width() || endy > m_bot.Map().height())
+	if (!canPlaceLocally(b.type, bx, by))
 	{
 		return false;
 	}
 
-	
 	if (Util::IsTownHallType(b.type))
 	{
 		return buildable(b, startx, starty);
@@ -157,6 +356,30 @@ bool BuildingPlacer::canBuildHereWithSpace(int bx, int by, const Building & b, i
 	return true;
 }
 
+// the rectangle around the footprint of b at (bx, by) that has to be free. False if it does not fit on the map.
+bool BuildingPlacer::getSpaceRect(int bx, int by, const Building & b, int buildDist, int & startx, int & starty, int & endx, int & endy) const
+{
+	// height and width of the building
+	int width  = Util::GetUnitTypeWidth(b.type, m_bot);
+	int height = Util::GetUnitTypeHeight(b.type, m_bot);
+
+	// TODO: make sure we leave space for add-ons. These types of units can have addons:
+
+	// define the rectangle of the building spot
+	startx = footprintStart(bx, width) - buildDist;
+	starty = footprintStart(by, height) - buildDist;
+	endx   = footprintStart(bx, width) + width + buildDist;
+	endy   = footprintStart(by, height) + height + buildDist;
+
+	if (b.type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || b.type == sc2::UNIT_TYPEID::TERRAN_FACTORY || b.type == sc2::UNIT_TYPEID::TERRAN_STARPORT)
+	{
+		--startx;
+		endx += 2;
+	}
+	// if this rectangle doesn't fit on the map we can't build here
+	return !(startx < 0 || starty < 0 || endx > m_bot.Map().width() || endy > m_bot.Map().height());
+}
+
 //We will never speak of this again....
 sc2::Point2D BuildingPlacer::getTownHallLocationNear(const Building & b)
 {
@@ -165,6 +388,7 @@ sc2::Point2D BuildingPlacer::getTownHallLocationNear(const Building & b)
 
 sc2::Point2D BuildingPlacer::getBuildLocationNear(const Building & b, int buildDist)
 {
+	ProfileScope profile(m_bot.Profiler(), "BuildLocation");
 	Timer t;
 	t.start();
 
@@ -175,8 +399,7 @@ sc2::Point2D BuildingPlacer::getBuildLocationNear(const Building & b, int buildD
 	auto idx = std::find(m_buildLocationTester.begin(), m_buildLocationTester.end(),newBuildingPlacePrototype);
 	if (idx == m_buildLocationTester.end())
 	{
-		const std::vector<sc2::Point2D> & closestToBuilding = m_bot.Map().getClosestTilesTo(b.desiredPosition);
-		buildingPlace newBuildingPlace(b.desiredPosition, buildingHash,b, closestToBuilding);
+		buildingPlace newBuildingPlace(b.desiredPosition, buildingHash,b, *m_bot.Map().getClosestTilesTo(b.desiredPosition));
 		m_buildLocationTester.push_back(newBuildingPlace);
 		idx = std::prev(m_buildLocationTester.end());
 	}
@@ -185,7 +408,7 @@ sc2::Point2D BuildingPlacer::getBuildLocationNear(const Building & b, int buildD
 	{
 		sc2::Point2D pos = idx->m_closestTiles[i];
 
-		if (canBuildHereWithSpace((int)pos.x, (int)pos.y, b, buildDist))
+		if (canBuildHereWithSpace((int)pos.x, (int)pos.y, b, buildDist) && confirmPlacement(b, (int)pos.x, (int)pos.y))
 		{
 			double ms = t.getElapsedTimeInMilliSec();
 			//printf("Building Placer Took %d iterations, lasting %lf ms @ %lf iterations/ms, %lf setup ms\n", (int)i, ms, (i / ms), ms1);
@@ -214,8 +437,8 @@ bool BuildingPlacer::tileOverlapsBaseLocation(int x, int y, sc2::UnitTypeID type
 	}
 
 	// dimensions of the proposed location
-	int tx1 = x;
-	int ty1 = y;
+	int tx1 = footprintStart(x, Util::GetUnitTypeWidth(type, m_bot));
+	int ty1 = footprintStart(y, Util::GetUnitTypeHeight(type, m_bot));
 	int tx2 = tx1 + Util::GetUnitTypeWidth(type, m_bot);
 	int ty2 = ty1 + Util::GetUnitTypeHeight(type, m_bot);
 
@@ -223,10 +446,11 @@ bool BuildingPlacer::tileOverlapsBaseLocation(int x, int y, sc2::UnitTypeID type
 	for (const BaseLocation * base : m_bot.Bases().getBaseLocations())
 	{
 		// dimensions of the base location
-		int bx1 = (int)base->getDepotPosition().x;
-		int by1 = (int)base->getDepotPosition().y;
-		int bx2 = bx1 + Util::GetUnitTypeWidth(Util::GetTownHall(m_bot.GetPlayerRace(Players::Self)), m_bot);
-		int by2 = by1 + Util::GetUnitTypeHeight(Util::GetTownHall(m_bot.GetPlayerRace(Players::Self)), m_bot);
+		const sc2::UnitTypeID townHall = Util::GetTownHall(m_bot.GetPlayerRace(Players::Self));
+		int bx1 = footprintStart((int)base->getDepotPosition().x, Util::GetUnitTypeWidth(townHall, m_bot));
+		int by1 = footprintStart((int)base->getDepotPosition().y, Util::GetUnitTypeHeight(townHall, m_bot));
+		int bx2 = bx1 + Util::GetUnitTypeWidth(townHall, m_bot);
+		int by2 = by1 + Util::GetUnitTypeHeight(townHall, m_bot);
 
 		// conditions for non-overlap are easy
 		bool noOverlap = (tx2 < bx1) || (tx1 > bx2) || (ty2 < by1) || (ty1 > by2);
@@ -245,7 +469,12 @@ bool BuildingPlacer::tileOverlapsBaseLocation(int x, int y, sc2::UnitTypeID type
 bool BuildingPlacer::buildable(const Building & b, int x, int y) const
 {
 	// TODO: does this take units on the map into account?
-	if (!m_bot.Map().isValid(x, y) || !m_bot.Map().canBuildTypeAtPosition(x, y, b.type))
+	if (!m_bot.Map().isValid(x, y))
+	{
+		return false;
+	}
+	// the space around the building does not need room for another addon
+	if (!canPlaceLocally(b.type, x, y, false))
 	{
 		return false;
 	}
@@ -257,17 +486,26 @@ bool BuildingPlacer::buildable(const Building & b, int x, int y) const
 
 void BuildingPlacer::reserveTiles(int bx, int by, int width, int height)
 {
-	size_t rwidth = m_reserveMap.size();
-	size_t rheight = m_reserveMap[0].size();
-	for (size_t x = bx; x < bx + width && x < rwidth; x++)
+	int rwidth = (int)m_reserveMap.size();
+	int rheight = (int)m_reserveMap[0].size();
+	for (int x = std::max(bx, 0); x < bx + width && x < rwidth; x++)
 	{
-		for (size_t y = by; y < by + height && y < rheight; y++)
+		for (int y = std::max(by, 0); y < by + height && y < rheight; y++)
 		{
 			m_reserveMap[x][y] = true;
 		}
 	}
 }
 
+// the footprint of b at its final position and the room for the addon of production buildings
+void BuildingPlacer::reserveTiles(const Building & b)
+{
+	const int width = Util::GetUnitTypeWidth(b.type, m_bot);
+	const int height = Util::GetUnitTypeHeight(b.type, m_bot);
+	const bool addon = b.type == sc2::UNIT_TYPEID::TERRAN_BARRACKS || b.type == sc2::UNIT_TYPEID::TERRAN_FACTORY || b.type == sc2::UNIT_TYPEID::TERRAN_STARPORT;
+	reserveTiles(footprintStart((int)b.finalPosition.x, width), footprintStart((int)b.finalPosition.y, height), addon ? width + 2 : width, height);
+}
+
 void BuildingPlacer::drawReservedTiles()
 {
 	if (!m_bot.Config().DrawReservedBuildingTiles)
@@ -300,15 +538,23 @@ void BuildingPlacer::freeTiles(int bx, int by, int width, int height)
 	int rwidth = (int)m_reserveMap.size();
 	int rheight = (int)m_reserveMap[0].size();
 
-	for (int x = bx; x < bx + width && x < rwidth; x++)
+	for (int x = std::max(bx, 0); x < bx + width && x < rwidth; x++)
 	{
-		for (int y = by; y < by + height && y < rheight; y++)
+		for (int y = std::max(by, 0); y < by + height && y < rheight; y++)
 		{
 			m_reserveMap[x][y] = false;
 		}
 	}
 }
 
+// the footprint of b, the room for its addon stays reserved
+void BuildingPlacer::freeTiles(const Building & b)
+{
+	const int width = Util::GetUnitTypeWidth(b.type, m_bot);
+	const int height = Util::GetUnitTypeHeight(b.type, m_bot);
+	freeTiles(footprintStart((int)b.finalPosition.x, width), footprintStart((int)b.finalPosition.y, height), width, height);
+}
+
 void BuildingPlacer::freeTiles()
 {
 	m_reserveMap = std::vector< std::vector<bool> >(m_bot.Map().width(), std::vector<bool>(m_bot.Map().height(), false));
@@ -343,7 +589,8 @@ sc2::Point2D BuildingPlacer::getRefineryPosition()
 		{
 			double homeDistance = Util::Dist(unit->pos, homePosition);
 
-			if (m_bot.Query()->Placement(sc2::ABILITY_ID::BUILD_REFINERY, geyserPos))
+			// running ahead, a geyser the game was not asked about waits for the next step
+			if (getPlacement(sc2::UNIT_TYPEID::TERRAN_REFINERY, geyserPos) == Placeable)
 			{
 				if (homeDistance < minGeyserDistanceFromHome)
 				{
@@ -5,6 +5,7 @@
 
 class CCBot;
 class BaseLocation;
+struct UnitDeltas;
 
 struct buildingPlace
 {
@@ -42,7 +43,23 @@ class BuildingPlacer
 	std::vector< std::vector<bool> > m_reserveMap;
 	std::vector<buildingPlace> m_buildLocationTester;
 
+	// tiles covered by structures and resources, rebuilt when a building appears or vanishes
+	std::vector< std::vector<bool> > m_occupied;
+	bool m_occupancyDirty;
+
+	// placement query results per building type and tile. Only buildings change them, so they stay until one appears or vanishes.
+	mutable std::unordered_map<uint32_t, std::vector<char>> m_placementCache;
+	// asked while running ahead, for the next onFrame of the scheduler
+	std::vector<std::pair<sc2::UnitTypeID, sc2::Point2D>> m_deferredPlacements;
+
 	void expandBuildingTesterOnce();
+	void			updateOccupancy();
+	int				getFootprintSize(const sc2::Unit * unit) const;
+	bool			isPlaceableTile(int x, int y) const;
+	bool			confirmPlacement(const Building & b, int x, int y);
+	std::vector<char> & getPlacementCache(sc2::UnitTypeID type) const;
+	void			resolveDeferredPlacements();
+	bool			getSpaceRect(int bx, int by, const Building & b, int buildDist, int & startx, int & starty, int & endx, int & endy) const;
 	// queries for various BuildingPlacer data
 	bool			buildable(const Building & b, int x, int y) const;
 	bool			isReserved(int x, int y) const;
@@ -52,15 +69,24 @@ class BuildingPlacer
 
 public:
 
+	enum PlacementState : char { Unknown = 0, Placeable, Blocked };
+
 	BuildingPlacer(CCBot & bot);
 
 	void onStart();
 
 	void onFrame();
+	// every step, the cache has to see the buildings of every step
+	void			onUnitDeltas(const UnitDeltas & deltas);
+	// onFrame does this first, for checking the placement rules without placing anything
+	void			updatePlacementCache();
 
 	// determines whether we can build at a given location
+	bool			canPlaceLocally(sc2::UnitTypeID type, int x, int y, bool withAddon = true) const;
 	bool			canBuildHere(int bx, int by, const Building & b) const;
 	bool			canBuildHereWithSpace(int bx, int by, const Building & b, int buildDist) const;
+	// the game's answer for placing type at pos, cached for the tile. Unknown while running ahead until the next step asked
+	PlacementState	getPlacement(sc2::UnitTypeID type, const sc2::Point2D & pos);
 
 	// returns a build location near a building's desired location
 	sc2::Point2D	getBuildLocationNear(const Building & b, int buildDist);
@@ -69,7 +95,9 @@ public:
 	void			drawReservedTiles();
 
 	void			reserveTiles(int x, int y, int width, int height);
+	void			reserveTiles(const Building & b);
 	void			freeTiles(int x, int y, int width, int height);
+	void			freeTiles(const Building & b);
 	void			freeTiles();
 	sc2::Point2D	getRefineryPosition();
 };
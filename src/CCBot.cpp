@@ -2,6 +2,7 @@
 
 #include "CCBot.h"
 #include "Util.h"
+#include "AllocationTracker.h"
 #include "AutoObserver/CameraModule.h"
 
 int lvl85 = 0;
@@ -10,13 +11,23 @@ int lvl10000 = 0;
 double maxStepTime = -1.0;
 
 CCBot::CCBot()
-	: m_map(*this)
+	: m_observation(nullptr)
+	, m_query(nullptr)
+	, m_rawActions(nullptr)
+	, m_map(*this)
 	, m_bases(*this)
 	, m_unitInfo(*this)
 	, m_workers(*this)
 	, m_gameCommander(*this)
 	, m_strategy(*this)
 	, m_techTree(*this)
+	, m_abilities(*this)
+	, m_commands(*this)
+	, m_pathing(*this)
+	, m_scheduler(*this)
+	, m_fineStep(false)
+	, m_profiler(*this)
+	, m_recorder(*this)
 	, m_cameraModule(this)
 {
 	
@@ -25,6 +36,24 @@ CCBot::CCBot()
 void CCBot::OnGameStart() 
 {
 	m_config.readConfigFile();
+	m_profiler.setEnabled(m_config.DrawModuleTimers || m_config.WriteProfile || m_config.WriteTrace || m_config.ProfileApiCalls || m_config.TrackAllocations);
+	AllocationTracker::setEnabled(m_config.TrackAllocations);
+	m_profiler.setTracing(m_config.WriteTrace);
+	// a stand-in game is a replay or the bench already, unless it asked to be recorded
+	if (m_recordFile.empty() && m_config.RecordObservations && !m_observation)
+	{
+		m_recordFile = m_config.WriteDir + "observations.rec";
+	}
+	if (!m_recordFile.empty() && m_recorder.start(m_recordFile, Query(), RawActions()))
+	{
+		m_query = &m_recorder;
+		m_rawActions = &m_recorder;
+	}
+	// counts the calls of the recorder too, they are what the game sees
+	if (m_config.ProfileApiCalls)
+	{
+		m_apiCalls.start(Observation(), Query());
+	}
 	
 	// get my race
 	auto playerID = Observation()->GetPlayerID();
@@ -46,6 +75,21 @@ void CCBot::OnGameStart()
 	m_bases.onStart();
 	m_workers.onStart();
 
+	m_scheduler.addTask("Bases", 1, TaskPriority::Critical, 0.5, [this]()
+	{
+		m_commands.setPriority(CommandPriority::Economy);
+		m_bases.onFrame();
+	});
+	m_scheduler.addTask("Workers", 1, TaskPriority::High, 1.0, [this]()
+	{
+		m_commands.setPriority(CommandPriority::Economy);
+		m_workers.onFrame();
+	}, true);
+	m_scheduler.addTask("Strategy", 22, TaskPriority::Low, 0.1, [this]()
+	{
+		m_commands.setPriority(CommandPriority::Economy);
+		m_strategy.onFrame();
+	}, true);
 	m_gameCommander.onStart();
 	if (useAutoObserver)
 	{
@@ -58,19 +102,48 @@ void CCBot::OnStep()
 {
 	Timer t;
 	t.start();
-	Control()->GetObservation();
+	const size_t allocations = AllocationTracker::allocations();
+	const size_t allocatedBytes = AllocationTracker::bytes();
+	m_profiler.onFrame();
+	m_profiler.drawInfo();
+	ProfileScope profile(m_profiler, "Step");
+	{
+		ProfileScope observation(m_profiler, "GetObservation", "api");
+		if (!m_observation)
+		{
+			ApiCall call(m_apiCalls, "GetObservation");
+			Control()->GetObservation();
+		}
+	}
+	m_recorder.onStep();
 
 	m_map.onFrame();
 	m_unitInfo.onFrame();
-	m_bases.onFrame();
-	m_workers.onFrame();
-	m_strategy.onFrame();
-	m_gameCommander.onFrame();
+	m_abilities.onFrame();
+	m_pathing.onFrame();
+
+	// what the latency tolerant managers decided while the game simulated this step
+	m_commands.append(m_aheadCommands);
+	m_aheadCommands.clear();
+
+	// publish what changed since the last frame so nobody has to rescan all units
+	const UnitDeltas & deltas = m_unitInfo.getUnitDeltas();
+	m_workers.onUnitDeltas(deltas);
+	m_workers.onDamageEvents(m_unitInfo.getDamageEvents());
+	m_gameCommander.onUnitDeltas(deltas);
+
+	m_scheduler.onFrame();
+	m_recorder.onTasks(m_scheduler.getLastRun(), false);
 
 	if (useAutoObserver)
 	{
+		for (const auto & damage : m_unitInfo.getDamageEvents())
+		{
+			m_cameraModule.onUnitDamaged(damage.unit);
+		}
 		m_cameraModule.onFrame();
 	}
+	m_commands.flush();
 	if (!useDebug)
 	{
 		return;
@@ -92,17 +165,54 @@ void CCBot::OnStep()
 			}
 		}
 	}
-	Drawing::drawTextScreen(*this, sc2::Point2D(0.85f, 0.6f), "Step time: " + std::to_string(int(std::round(ms))) + "ms\nMax step time: " + std::to_string(int(std::round(maxStepTime))) + "ms\n" + "#Frames >	85ms: " + std::to_string(lvl85) + "\n#Frames >  1000ms: " + std::to_string(lvl1000) + "\n#Frames > 10000ms: " + std::to_string(lvl10000), sc2::Colors::White, 16);
+	std::string profileInfo;
+	if (m_apiCalls.isEnabled())
+	{
+		profileInfo = "\nAPI calls last step: " + std::to_string(m_apiCalls.getLastCalls()) + " (" + std::to_string(int(std::round(m_apiCalls.getLastMs()))) + "ms)";
+	}
+	if (AllocationTracker::isEnabled())
+	{
+		profileInfo += "\nAllocations: " + std::to_string(AllocationTracker::allocations() - allocations) + " (" + std::to_string((AllocationTracker::bytes() - allocatedBytes) / 1024) + "KB)";
+	}
+	Drawing::drawTextScreen(*this, sc2::Point2D(0.85f, 0.6f), "Step time: " + std::to_string(int(std::round(ms))) + "ms\nMax step time: " + std::to_string(int(std::round(maxStepTime))) + "ms\n" + "#Frames >	85ms: " + std::to_string(lvl85) + "\n#Frames >  1000ms: " + std::to_string(lvl1000) + "\n#Frames > 10000ms: " + std::to_string(lvl10000) + "\nActions sent: " + std::to_string(m_commands.getSentThisFrame()) + " (" + std::to_string(m_commands.getSent()) + ")\nCommands suppressed: " + std::to_string(m_commands.getSuppressedThisFrame()) + " (" + std::to_string(m_commands.getSuppressed()) + ")\nCommands deferred: " + std::to_string(m_commands.getDeferredThisFrame()) + profileInfo, sc2::Colors::White, 16);
 	//std::cout << "#Frames > 85: " << lvl85 << ",	#Frames > 1000: " << lvl1000 << ",	#Frames > 10000ms: " << lvl10000 << std::endl;
 	//if (Observation()->GetGameLoop() == 100)
 	//{
 	//	Debug()->DebugCreateUnit(sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR, Bases().getNextExpansion(Players::Self), 2, 1);
 	//}
+	ApiCall call(m_apiCalls, "SendDebug");
 	Debug()->SendDebug();
 }
 
+// runs the latency tolerant managers on this observation while the game simulates the next step, see main.cpp.
+// Their commands are sent with the next step.
+void CCBot::OnStepAhead()
+{
+	ProfileScope profile(m_profiler, "StepAhead");
+	m_scheduler.setPipelined(true);
+	CommandBuffer::Recorder recorder(m_aheadCommands);
+	m_scheduler.onFrameAhead();
+	m_recorder.onTasks(m_scheduler.getLastRun(), true);
+}
+
+void CCBot::OnGameEnd()
+{
+	m_recorder.stop();
+	m_profiler.onFrame();
+	if (m_config.WriteProfile)
+	{
+		m_profiler.writeReport(m_config.WriteDir + "profile");
+	}
+	if (m_config.WriteTrace)
+	{
+		m_profiler.writeTrace(m_config.WriteDir + "trace.json");
+	}
+}
+
 void CCBot::OnUnitCreated(const sc2::Unit * unit)
 {
+	m_recorder.onEvent(RecordedEventType::Created, unit);
+	m_commands.setPriority(CommandPriority::Combat);
 	m_gameCommander.onUnitCreate(unit);
 	if (useAutoObserver)
 	{
@@ -110,14 +220,28 @@ void CCBot::OnUnitCreated(const sc2::Unit * unit)
 	}
 }
 
+void CCBot::OnUnitDestroyed(const sc2::Unit * unit)
+{
+	m_recorder.onEvent(RecordedEventType::Destroyed, unit);
+	m_unitInfo.onUnitDestroyed(unit);
+}
+
+void CCBot::OnUnitIdle(const sc2::Unit * unit)
+{
+	m_recorder.onEvent(RecordedEventType::Idle, unit);
+	m_unitInfo.onUnitIdle(unit);
+}
+
 void CCBot::OnBuildingConstructionComplete(const sc2::Unit * unit)
 {
+	m_recorder.onEvent(RecordedEventType::ConstructionComplete, unit);
 	m_gameCommander.OnBuildingConstructionComplete(unit);
 }
 
 
 void CCBot::OnUnitEnterVision(const sc2::Unit * unit)
 {
+	m_recorder.onEvent(RecordedEventType::EnterVision, unit);
 	m_gameCommander.OnUnitEnterVision(unit);
 }
 
@@ -179,6 +303,76 @@ WorkerManager & CCBot::Workers()
 	return m_workers;
 }
 
+AbilityCache & CCBot::Abilities()
+{
+	return m_abilities;
+}
+
+PathingQueryBatcher & CCBot::Pathing()
+{
+	return m_pathing;
+}
+
+TaskScheduler & CCBot::Scheduler()
+{
+	return m_scheduler;
+}
+
+ThreadPool & CCBot::Threads()
+{
+	return m_threads;
+}
+
+ModuleProfiler & CCBot::Profiler()
+{
+	return m_profiler;
+}
+
+ApiProfiler & CCBot::ApiCalls()
+{
+	return m_apiCalls;
+}
+
+CommandBuffer * CCBot::Actions()
+{
+	return &m_commands;
+}
+
+const sc2::ObservationInterface * CCBot::Observation() const
+{
+	if (m_apiCalls.isEnabled())
+	{
+		return m_apiCalls.getObservation();
+	}
+	return m_observation ? m_observation : sc2::Agent::Observation();
+}
+
+sc2::QueryInterface * CCBot::Query()
+{
+	if (m_apiCalls.isEnabled())
+	{
+		return m_apiCalls.getQuery();
+	}
+	return m_query ? m_query : sc2::Agent::Query();
+}
+
+sc2::ActionInterface * CCBot::RawActions()
+{
+	return m_rawActions ? m_rawActions : sc2::Agent::Actions();
+}
+
+void CCBot::recordTo(const std::string & fileName)
+{
+	m_recordFile = fileName;
+}
+
+void CCBot::setStandIns(const sc2::ObservationInterface * observation, sc2::QueryInterface * query, sc2::ActionInterface * actions)
+{
+	m_observation = observation;
+	m_query = query;
+	m_rawActions = actions;
+}
+
 const sc2::Unit * CCBot::GetUnit(const UnitTag & tag) const
 {
 	return Observation()->GetUnit(tag);
@@ -204,6 +398,17 @@ void CCBot::requestGuards(const bool req)
 	m_gameCommander.requestGuards(req);
 }
 
+void CCBot::requestFineStep()
+{
+	m_fineStep = true;
+}
+
+// the request holds until the step size is read, also the ones of tasks running ahead after OnStep
+int CCBot::getStepSize(const int stepSize)
+{
+	return m_fineStep.exchange(false) ? 1 : stepSize;
+}
+
 
 
 void * CreateNewAgent()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sc2api/sc2_api.h"
+#include <atomic>
 
 #include "MapTools.h"
 #include "BaseLocationManager.h"
@@ -11,6 +12,14 @@
 #include "BuildingManager.h"
 #include "StrategyManager.h"
 #include "TechTree.h"
+#include "AbilityCache.h"
+#include "CommandBuffer.h"
+#include "PathingQueryBatcher.h"
+#include "TaskScheduler.h"
+#include "ThreadPool.h"
+#include "ModuleProfiler.h"
+#include "ApiProfiler.h"
+#include "ObservationRecorder.h"
 #include "BuildType.h"
 #include "AutoObserver/CameraModule.h"
 #include "Drawing.h"
@@ -18,6 +27,10 @@
 class CCBot : public sc2::Agent 
 {
 	sc2::Race			   m_playerRace[2];
+	// stand-ins for the game, e.g. the bench's MockGame. Null uses the real interfaces
+	const sc2::ObservationInterface *	m_observation;
+	sc2::QueryInterface *				m_query;
+	sc2::ActionInterface *				m_rawActions;
 
 	MapTools				m_map;
 	BaseLocationManager	 m_bases;
@@ -26,9 +39,22 @@ class CCBot : public sc2::Agent
 	StrategyManager		 m_strategy;
 	BotConfig			   m_config;
 	TechTree				m_techTree;
+	AbilityCache			m_abilities;
+	CommandBuffer			m_commands;
+	PathingQueryBatcher		m_pathing;
+	TaskScheduler			m_scheduler;
+	CommandBuffer::CommandList	m_aheadCommands;
+	// set by micro that needs to see the next game loop, squads run on several threads
+	std::atomic<bool>		m_fineStep;
+	ApiProfiler				m_apiCalls;
+	ModuleProfiler			m_profiler;
+	ObservationRecorder		m_recorder;
+	std::string				m_recordFile;
 
 	GameCommander		   m_gameCommander;
 	CameraModuleAgent		m_cameraModule;
+	// last, so the jobs are done before the data they read goes away
+	ThreadPool				m_threads;
 
 	void OnError(const std::vector<sc2::ClientError> & client_errors, 
 				 const std::vector<std::string> & protocol_errors = {}) override;
@@ -38,15 +64,37 @@ public:
 	CCBot();
 	void OnGameStart() override;
 	void OnStep() override;
+	void OnStepAhead();
+	void OnGameEnd() override;
 
 	void OnUnitCreated(const sc2::Unit * unit) override;
+	void OnUnitDestroyed(const sc2::Unit * unit) override;
+	void OnUnitIdle(const sc2::Unit * unit) override;
 	void OnBuildingConstructionComplete(const sc2::Unit * unit) override;
 	void OnUnitEnterVision(const sc2::Unit * unit) override;
 
 	void OnDTdetected(const sc2::Point2D pos);
 
+	// hides sc2::Client::Actions, all unit commands go through the buffer and are sent once per step
+	CommandBuffer * Actions();
+	// hide sc2::Client::Observation and sc2::Agent::Query, so a stand-in can answer instead of the game and ApiCalls can count
+	const sc2::ObservationInterface * Observation() const;
+	sc2::QueryInterface * Query();
+	// where the buffered commands go
+	sc2::ActionInterface * RawActions();
+	// the bot then runs without a game: OnStep no longer asks the game for an observation
+	void setStandIns(const sc2::ObservationInterface * observation, sc2::QueryInterface * query, sc2::ActionInterface * actions);
+	// records the game to fileName as RecordObservations does, also a stand-in game. Call it before OnGameStart
+	void recordTo(const std::string & fileName);
+
 		  BotConfig & Config();
 		  WorkerManager & Workers();
+		  AbilityCache & Abilities();
+		  PathingQueryBatcher & Pathing();
+		  TaskScheduler & Scheduler();
+		  ThreadPool & Threads();
+		  ModuleProfiler & Profiler();
+		  ApiProfiler & ApiCalls();
 	const BaseLocationManager & Bases() const;
 	const MapTools & Map() const;
 	const UnitInfoManager & UnitInfo() const;
@@ -59,6 +107,10 @@ public:
 	const sc2::Unit * GetUnit(const UnitTag & tag) const;
 	const ProductionManager & Production();
 	void requestGuards(const bool req);
+	// time critical micro asks for this, the game then advances only one loop for the next step
+	void requestFineStep();
+	// the number of loops the next step advances, it takes back a fine step request
+	int getStepSize(const int stepSize);
 };
 
 extern bool useDebug;
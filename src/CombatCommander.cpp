@@ -10,6 +10,11 @@ const size_t BaseDefensePriority = 3;
 const size_t ScoutDefensePriority = 4;
 const size_t DropPriority = 5;
 
+//Enemies that left our vision still count for defense until they could have moved about 10 tiles
+const float minDefenseConfidence = 0.5f;
+//Defense squads move their order to where the threat is once it is this far from it
+const float defenseOrderStep = 4.0f;
+
 CombatCommander::CombatCommander(CCBot & bot)
 	: m_bot(bot)
 	, m_squadData(bot)
@@ -40,43 +45,42 @@ void CombatCommander::onStart()
 	m_squadData.addSquad("GuardDuty", Squad("GuardDuty", enemyScoutDefense, ScoutDefensePriority, m_bot));
 }
 
-bool CombatCommander::isSquadUpdateFrame()
-{
-	return true;
-}
-
-void CombatCommander::onFrame(const std::vector<const sc2::Unit *> & combatUnits)
+void CombatCommander::setCombatUnits(const std::vector<const sc2::Unit *> & combatUnits)
 {
+	m_combatUnits = combatUnits;
 	if (!m_attackStarted)
 	{
 		m_attackStarted = shouldWeStartAttacking();
 	}
+}
 
-	m_combatUnits = combatUnits;
-
-	if (isSquadUpdateFrame())
-	{
-		updateIdleSquad();
-		updateScoutDefenseSquad();
-		updateDefenseSquads();
-		updateAttackSquads();
-		updateGuardSquads();
-	}
+// scheduled on its own, under load the squads keep their units for a step
+void CombatCommander::updateSquads()
+{
+	updateIdleSquad();
+	updateScoutDefenseSquad();
+	updateDefenseSquads();
+	updateAttackSquads();
+	updateGuardSquads();
+}
 
+void CombatCommander::onFrame()
+{
 	m_squadData.onFrame();
 }
 
+void CombatCommander::onUnitDeltas(const UnitDeltas & deltas)
+{
+	m_squadData.onUnitDeltas(deltas);
+}
+
 bool CombatCommander::shouldWeStartAttacking()
 {
 	// TODO: make this more clever
 	// For now: start attacking when we have more than 10 combat units
-	auto upgrades = m_bot.Observation()->GetUpgrades();
-	for (auto & upgrade : upgrades)
+	if (m_bot.UnitInfo().hasUpgrade(sc2::UPGRADE_ID::STIMPACK) && m_combatUnits.size() >= m_bot.Config().CombatUnitsForAttack)
 	{
-		if (upgrade.ToType() == sc2::UPGRADE_ID::STIMPACK && m_combatUnits.size() >= m_bot.Config().CombatUnitsForAttack)
-		{
-			return true;
-		}
+		return true;
 	}
 	return m_combatUnits.size() >= 100;
 }
@@ -242,19 +246,29 @@ void CombatCommander::updateDefenseSquads()
 		// start off assuming all enemy units in region are just workers
 		int numDefendersPerEnemyUnit = 2;
 
-		// all of the enemy units in this region
+		// all of the enemy units in this region, including the ones that just left our vision.
+		// The pos of those is where we saw them last, where they are is the predicted position.
 		std::vector<const sc2::Unit *> enemyUnitsInRegion;
-		for (auto & unit : m_bot.UnitInfo().getUnits(Players::Enemy))
+		sc2::Point2D threatPosition = basePosition;
+		float threatDistance = std::numeric_limits<float>::max();
+		for (const auto & kv : m_bot.UnitInfo().getUnitInfoMap(Players::Enemy))
 		{
+			const UnitInfo & ui = kv.second;
 			// if it's an overlord, don't worry about it for defense, we don't care what they see
-			if (unit->unit_type == sc2::UNIT_TYPEID::ZERG_OVERLORD)
+			if (ui.type == sc2::UNIT_TYPEID::ZERG_OVERLORD || ui.confidence < minDefenseConfidence)
 			{
 				continue;
 			}
 
-			if (Util::Dist(basePosition,unit->pos)<25)
+			const float dist = Util::Dist(basePosition, ui.predictedPosition);
+			if (dist < 25)
 			{
-				enemyUnitsInRegion.push_back(unit);
+				enemyUnitsInRegion.push_back(ui.unit);
+				if (dist < threatDistance)
+				{
+					threatDistance = dist;
+					threatPosition = ui.predictedPosition;
+				}
 			}
 		}
 
@@ -312,7 +326,7 @@ void CombatCommander::updateDefenseSquads()
 			// if we don't have a squad assigned to this region already, create one
 			if (!m_squadData.squadExists(squadName.str()))
 			{
-				SquadOrder defendRegion(SquadOrderTypes::Defend, basePosition, 32 * 25, "Defend Region!");
+				SquadOrder defendRegion(SquadOrderTypes::Defend, threatPosition, 32 * 25, "Defend Region!");
 				m_squadData.addSquad(squadName.str(), Squad(squadName.str(), defendRegion, BaseDefensePriority, m_bot));
 			}
 		}
@@ -322,6 +336,12 @@ void CombatCommander::updateDefenseSquads()
 		{
 			Squad & defenseSquad = m_squadData.getSquad(squadName.str());
 
+			// defenders without a target go to the closest threat. Only follow it in larger steps, every new position needs a distance map.
+			if (Util::Dist(defenseSquad.getSquadOrder().getPosition(), threatPosition) > defenseOrderStep)
+			{
+				defenseSquad.setSquadOrder(SquadOrder(SquadOrderTypes::Defend, threatPosition, 32 * 25, "Defend Region!"));
+			}
+
 			// figure out how many units we need on defense
 			int flyingDefendersNeeded = numDefendersPerEnemyUnit * numEnemyFlyingInRegion;
 			int groundDefensersNeeded = numDefendersPerEnemyUnit * numEnemyGroundInRegion;
@@ -347,9 +367,9 @@ void CombatCommander::updateDefenseSquads()
 		}
 
 		bool enemyUnitInRange = false;
-		for (auto & unit : m_bot.UnitInfo().getUnits(Players::Enemy))
+		for (const auto & kv : m_bot.UnitInfo().getUnitInfoMap(Players::Enemy))
 		{
-			if (Util::Dist(unit->pos, order.getPosition()) < order.getRadius())
+			if (kv.second.confidence >= minDefenseConfidence && Util::Dist(kv.second.predictedPosition, order.getPosition()) < order.getRadius())
 			{
 				enemyUnitInRange = true;
 				break;
@@ -407,7 +427,7 @@ void CombatCommander::updateDefenseSquadUnits(Squad & defenseSquad, const size_t
 		}
 	}
 	// Emergency draft of workers
-	const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BUNKER }));
+	const UnitSpan Bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 	while (defendersNeeded > defendersAdded && m_bot.UnitInfo().getNumCombatUnits(Players::Self)<20 && (Bunker.empty() || Bunker.front()->cargo_space_taken==0))
 	{
 		const sc2::Unit * workerDefender = findClosestWorkerTo(m_bot.Workers().getMineralWorkers(),defenseSquad.getSquadOrder().getPosition());
@@ -516,14 +536,22 @@ sc2::Point2D CombatCommander::getMainAttackLocation()
 		return clostestEnemyBuildingPos;
 	}
 
-	// Third choice: Attack visible enemy units that aren't overlords
-	for (auto & enemyUnit : m_bot.UnitInfo().getUnits(Players::Enemy))
+	// Third choice: Attack enemy units that aren't overlords. Visible ones first, then where we think the others went
+	float maxConfidence = 0.0f;
+	sc2::Point2D mostLikelyEnemyPos(0.0f, 0.0f);
+	for (const auto & kv : m_bot.UnitInfo().getUnitInfoMap(Players::Enemy))
 	{
-		if (enemyUnit->unit_type != sc2::UNIT_TYPEID::ZERG_OVERLORD)
+		const UnitInfo & ui = kv.second;
+		if (ui.type != sc2::UNIT_TYPEID::ZERG_OVERLORD && ui.confidence > maxConfidence)
 		{
-			return enemyUnit->pos;
+			maxConfidence = ui.confidence;
+			mostLikelyEnemyPos = ui.predictedPosition;
 		}
 	}
+	if (maxConfidence > 0.0f)
+	{
+		return mostLikelyEnemyPos;
+	}
 
 	// Fourth choice: We can't see anything so explore the map attacking along the way
 	return m_bot.Map().getLeastRecentlySeenPosition();
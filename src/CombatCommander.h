@@ -21,7 +21,6 @@ class CombatCommander
 	void			updateAttackSquads();
 	void			updateGuardSquads();
 	void			updateIdleSquad();
-	bool			isSquadUpdateFrame();
 
 	const sc2::Unit * findClosestDefender(const Squad & defenseSquad, const sc2::Point2D & pos);
 	const sc2::Unit * findClosestWorkerTo(std::vector<const sc2::Unit *> unitsToAssign, const sc2::Point2D & target);
@@ -38,7 +37,10 @@ public:
 
 
 	void onStart();
-	void onFrame(const std::vector<const sc2::Unit *> & combatUnits);
+	void onFrame();
+	void setCombatUnits(const std::vector<const sc2::Unit *> & combatUnits);
+	void updateSquads();
+	void onUnitDeltas(const UnitDeltas & deltas);
 
 	void drawSquadInformation();
 	const bool underAttack() const;
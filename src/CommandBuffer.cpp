@@ -0,0 +1,294 @@
+#include "CommandBuffer.h"
+#include "CCBot.h"
+#include "Util.h"
+#include <algorithm>
+#include <limits>
+
+// orders to points closer than this are the same order
+const float samePointDistance = 0.5f;
+
+// the list of the Recorder of this thread
+thread_local CommandBuffer::CommandList * recording = nullptr;
+
+CommandBuffer::Recorder::Recorder(CommandList & list)
+{
+	BOT_ASSERT(!recording, "There is already a recorder on this thread");
+	recording = &list;
+}
+
+CommandBuffer::Recorder::~Recorder()
+{
+	recording = nullptr;
+}
+
+CommandBuffer::CommandBuffer(CCBot & bot)
+	: m_bot(bot)
+	, m_sentThisFrame(0)
+	, m_suppressedThisFrame(0)
+	, m_suppressedPending(0)
+	, m_deferredThisFrame(0)
+	, m_priority(CommandPriority::Economy)
+	, m_sent(0)
+	, m_suppressed(0)
+{
+
+}
+
+void CommandBuffer::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command)
+{
+	push({ unit, ability, TargetType::None, sc2::Point2D(), nullptr, queued_command, m_priority, m_bot.Observation()->GetGameLoop() });
+}
+
+void CommandBuffer::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	push({ unit, ability, TargetType::Point, point, nullptr, queued_command, m_priority, m_bot.Observation()->GetGameLoop() });
+}
+
+void CommandBuffer::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	if (!target)
+	{
+		return;
+	}
+	push({ unit, ability, TargetType::Unit, sc2::Point2D(), target, queued_command, m_priority, m_bot.Observation()->GetGameLoop() });
+}
+
+void CommandBuffer::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_command)
+{
+	for (const auto & unit : units)
+	{
+		UnitCommand(unit, ability, queued_command);
+	}
+}
+
+void CommandBuffer::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	for (const auto & unit : units)
+	{
+		UnitCommand(unit, ability, point, queued_command);
+	}
+}
+
+void CommandBuffer::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	for (const auto & unit : units)
+	{
+		UnitCommand(unit, ability, target, queued_command);
+	}
+}
+
+void CommandBuffer::SendChat(const std::string & message)
+{
+	m_bot.RawActions()->SendChat(message);
+}
+
+// the commands keep the priority and game loop they were given with
+void CommandBuffer::append(const CommandList & list)
+{
+	for (const auto & command : list)
+	{
+		add(command);
+	}
+}
+
+void CommandBuffer::push(const Command & command)
+{
+	if (!command.unit)
+	{
+		return;
+	}
+	if (recording)
+	{
+		recording->push_back(command);
+		return;
+	}
+	add(command);
+}
+
+void CommandBuffer::add(const Command & c)
+{
+	// a more important manager keeps the unit, whether its command came first or not
+	for (const auto & command : m_commands)
+	{
+		if (command.unit == c.unit && command.priority < c.priority)
+		{
+			++m_suppressedPending;
+			return;
+		}
+	}
+	for (auto it = m_commands.begin(); it != m_commands.end();)
+	{
+		if (it->unit != c.unit)
+		{
+			++it;
+			continue;
+		}
+		// the same command twice does not help either
+		if (it->ability == c.ability && it->targetType == c.targetType && it->target == c.target && it->queued == c.queued
+			&& Util::Dist(it->point, c.point) < samePointDistance)
+		{
+			it->priority = std::min(it->priority, c.priority);
+			++m_suppressedPending;
+			return;
+		}
+		// a new order replaces what is still waiting from earlier steps, anything less important managers wanted is replaced
+		if (it->priority > c.priority || (!c.queued && it->loop < c.loop))
+		{
+			it = m_commands.erase(it);
+			++m_suppressedPending;
+			continue;
+		}
+		// commands queued behind earlier ones have to be sent after them
+		it->priority = std::min(it->priority, c.priority);
+		++it;
+	}
+	if (isCurrentOrder(c))
+	{
+		++m_suppressedPending;
+		return;
+	}
+	m_commands.push_back(c);
+}
+
+// a targeted order the unit is already executing. If the unit has more orders queued, the new one would drop them.
+bool CommandBuffer::isCurrentOrder(const Command & command) const
+{
+	if (command.queued || command.targetType == TargetType::None || command.unit->orders.size() != 1)
+	{
+		return false;
+	}
+	const sc2::UnitOrder & order = command.unit->orders.front();
+	if (order.ability_id != command.ability)
+	{
+		// orders report the specific ability, e.g. ATTACK_ATTACK for ATTACK
+		const auto & abilities = m_bot.Observation()->GetAbilityData();
+		const uint32_t orderAbility = static_cast<uint32_t>(order.ability_id);
+		if (orderAbility >= abilities.size() || abilities[orderAbility].remaps_to_ability_id != static_cast<uint32_t>(command.ability))
+		{
+			return false;
+		}
+	}
+	if (command.targetType == TargetType::Unit)
+	{
+		return order.target_unit_tag == command.target->tag;
+	}
+	return Util::Dist(order.target_pos, command.point) < samePointDistance;
+}
+
+void CommandBuffer::setPriority(CommandPriority priority)
+{
+	m_priority = priority;
+}
+
+// units that got the same command are sent as one action. A unit only joins a group that is sent
+// after all its earlier commands, otherwise its queued commands could be reordered.
+void CommandBuffer::flush()
+{
+	ProfileScope profile(m_bot.Profiler(), "Commands");
+	const uint32_t loop = m_bot.Observation()->GetGameLoop();
+	// 0 means no limit
+	const size_t maxActions = m_bot.Config().MaxActionsPerStep > 0 ? static_cast<size_t>(m_bot.Config().MaxActionsPerStep) : std::numeric_limits<size_t>::max();
+	const uint32_t maxDelay = static_cast<uint32_t>(std::max(0, m_bot.Config().MaxActionDelay));
+
+	struct Group
+	{
+		const Command * command;
+		sc2::Units units;
+	};
+	std::vector<Group> groups;
+	std::unordered_map<const sc2::Unit *, size_t> lastGroupOfUnit;
+	std::set<const sc2::Unit *> deferredUnits;
+	std::vector<Command> deferred;
+	for (const auto priority : { CommandPriority::Combat, CommandPriority::Production, CommandPriority::Economy })
+	{
+		for (const auto & command : m_commands)
+		{
+			if (command.priority != priority)
+			{
+				continue;
+			}
+			// a command that waited might not make sense anymore
+			if (command.loop < loop && (!command.unit->is_alive || (command.target && !command.target->is_alive) || isCurrentOrder(command)))
+			{
+				++m_suppressedPending;
+				continue;
+			}
+			if (deferredUnits.count(command.unit))
+			{
+				deferred.push_back(command);
+				continue;
+			}
+			const auto last = lastGroupOfUnit.find(command.unit);
+			size_t g = last == lastGroupOfUnit.end() ? 0 : last->second;
+			for (; g < groups.size(); ++g)
+			{
+				const Command & c = *groups[g].command;
+				if (c.ability == command.ability && c.targetType == command.targetType && c.target == command.target && c.queued == command.queued
+					&& c.point.x == command.point.x && c.point.y == command.point.y)
+				{
+					break;
+				}
+			}
+			if (g == groups.size())
+			{
+				// joining a group is free, a new group is another action
+				const bool mustSend = priority == CommandPriority::Combat || loop - command.loop >= maxDelay;
+				if (!mustSend && groups.size() >= maxActions)
+				{
+					deferred.push_back(command);
+					deferredUnits.insert(command.unit);
+					continue;
+				}
+				groups.push_back({ &command, sc2::Units() });
+			}
+			groups[g].units.push_back(command.unit);
+			lastGroupOfUnit[command.unit] = g;
+		}
+	}
+
+	sc2::ActionInterface * actions = m_bot.RawActions();
+	for (const auto & group : groups)
+	{
+		const Command & c = *group.command;
+		switch (c.targetType)
+		{
+			case TargetType::None:  actions->UnitCommand(group.units, c.ability, c.queued); break;
+			case TargetType::Point: actions->UnitCommand(group.units, c.ability, c.point, c.queued); break;
+			case TargetType::Unit:  actions->UnitCommand(group.units, c.ability, c.target, c.queued); break;
+		}
+	}
+
+	m_sentThisFrame = groups.size();
+	m_sent += m_sentThisFrame;
+	m_suppressedThisFrame = m_suppressedPending;
+	m_suppressed += m_suppressedPending;
+	m_suppressedPending = 0;
+	m_deferredThisFrame = deferred.size();
+	m_commands.swap(deferred);
+	m_priority = CommandPriority::Economy;
+}
+
+size_t CommandBuffer::getSentThisFrame() const
+{
+	return m_sentThisFrame;
+}
+
+size_t CommandBuffer::getSuppressedThisFrame() const
+{
+	return m_suppressedThisFrame;
+}
+
+size_t CommandBuffer::getDeferredThisFrame() const
+{
+	return m_deferredThisFrame;
+}
+
+size_t CommandBuffer::getSent() const
+{
+	return m_sent;
+}
+
+size_t CommandBuffer::getSuppressed() const
+{
+	return m_suppressed;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Common.h"
+
+class CCBot;
+
+// in order of importance. Combat commands are never deferred
+enum class CommandPriority { Combat, Production, Economy };
+
+// collects all unit commands of a frame. Commands that repeat the current order or an earlier command
+// of the same frame are dropped, the rest is merged into multi unit actions and sent once per step.
+// If managers of different priority command the same unit, only the commands of the more important one are kept.
+// If a step would exceed MaxActionsPerStep, less important commands wait for a later step, but not longer than MaxActionDelay loops.
+class CommandBuffer
+{
+public:
+
+	enum class TargetType { None, Point, Unit };
+
+	struct Command
+	{
+		const sc2::Unit *	unit;
+		sc2::AbilityID		ability;
+		TargetType			targetType;
+		sc2::Point2D		point;
+		const sc2::Unit *	target;
+		bool				queued;
+		CommandPriority		priority;
+		uint32_t			loop;
+	};
+	typedef std::vector<Command> CommandList;
+
+	// while it exists, the commands given on this thread go into the list instead of the buffer.
+	// Used for work running in the background, the list is appended on the main thread afterwards.
+	class Recorder
+	{
+	public:
+		Recorder(CommandList & list);
+		~Recorder();
+	};
+
+private:
+
+	CCBot &					m_bot;
+	std::vector<Command>	m_commands;
+	size_t					m_sentThisFrame;
+	size_t					m_suppressedThisFrame;
+	size_t					m_suppressedPending;
+	size_t					m_deferredThisFrame;
+	CommandPriority			m_priority;
+	size_t					m_sent;
+	size_t					m_suppressed;
+
+	void		push(const Command & command);
+	void		add(const Command & command);
+	bool		isCurrentOrder(const Command & command) const;
+
+public:
+
+	CommandBuffer(CCBot & bot);
+
+	// same signatures as sc2::ActionInterface, so the call sites do not care where their command goes
+	void		UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false);
+	void		UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false);
+	void		UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false);
+	void		UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_command = false);
+	void		UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false);
+	void		UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false);
+	void		SendChat(const std::string & message);
+	// as if the commands had been given now, in the same order
+	void		append(const CommandList & list);
+
+	// the priority of all following commands until the next flush
+	void		setPriority(CommandPriority priority);
+	void		flush();
+
+	size_t		getSentThisFrame() const;
+	size_t		getSuppressedThisFrame() const;
+	size_t		getDeferredThisFrame() const;
+	size_t		getSent() const;
+	size_t		getSuppressed() const;
+};
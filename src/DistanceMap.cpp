@@ -31,10 +31,15 @@ const std::vector<sc2::Point2D> & DistanceMap::getSortedTiles() const
 // Computes m_dist[x][y] = ground distance from (startX, startY) to (x,y)
 // Uses BFS, since the map is quite large and DFS may cause a stack overflow
 void DistanceMap::computeDistanceMap(CCBot & m_bot, const sc2::Point2D & startTile)
+{
+	computeDistanceMap(m_bot.Map().getWalkableGrid(), startTile);
+}
+
+void DistanceMap::computeDistanceMap(const std::vector<std::vector<bool>> & walkable, const sc2::Point2D & startTile)
 {
 	m_startTile = startTile;
-	m_width = m_bot.Map().width();
-	m_height = m_bot.Map().height();
+	m_width = static_cast<int>(walkable.size());
+	m_height = m_width > 0 ? static_cast<int>(walkable.front().size()) : 0;
 	m_dist = std::vector<std::vector<int>>(m_width, std::vector<int>(m_height, -1));
 	m_sortedTilePositions.reserve(m_width * m_height);
 
@@ -56,7 +61,9 @@ void DistanceMap::computeDistanceMap(CCBot & m_bot, const sc2::Point2D & startTi
 			sc2::Point2D nextTile(tile.x + actionX[a], tile.y + actionY[a]);
 
 			// if the new tile is inside the map bounds, is walkable, and has not been visited yet, set the distance of its parent + 1
-			if (m_bot.Map().isWalkable(nextTile) && getDistance(nextTile) == -1)
+			const int x = (int)nextTile.x;
+			const int y = (int)nextTile.y;
+			if (x >= 0 && y >= 0 && x < m_width && y < m_height && walkable[x][y] && getDistance(nextTile) == -1)
 			{
 				m_dist[(int)nextTile.x][(int)nextTile.y] = m_dist[(int)tile.x][(int)tile.y] + 1;
 				fringe.push_back(nextTile);
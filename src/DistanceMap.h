@@ -19,6 +19,8 @@ public:
 	
 	DistanceMap();
 	void computeDistanceMap(CCBot & m_bot, const sc2::Point2D & startTile);
+	// does not need the bot, so it can run in the background
+	void computeDistanceMap(const std::vector<std::vector<bool>> & walkable, const sc2::Point2D & startTile);
 
 	int getDistance(int tileX, int tileY) const;
 	int getDistance(const sc2::Point2D & pos) const;
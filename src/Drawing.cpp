@@ -1,8 +1,10 @@
 #include "sc2api/sc2_api.h"
 #include "CCBot.h"
 #include "Drawing.h"
+#include <mutex>
 
-
+// squads draw from several threads
+std::mutex debugMutex;
 
 void Drawing::drawLine(CCBot & bot, float x1, float y1, float x2, float y2, const sc2::Color & color)
 {
@@ -11,6 +13,8 @@ void Drawing::drawLine(CCBot & bot, float x1, float y1, float x2, float y2, cons
 		return;
 	}
 	const float maxZ = bot.Map().getHeight(x1, y1);
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugLineOut");
 	bot.Debug()->DebugLineOut(sc2::Point3D(x1, y1, maxZ + 0.2f), sc2::Point3D(x2, y2, maxZ + 0.2f), color);
 }
 
@@ -21,6 +25,8 @@ void Drawing::drawLine(CCBot & bot, const sc2::Point2D & min, const sc2::Point2D
 		return;
 	}
 	const float maxZ = bot.Map().getHeight(min);
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugLineOut");
 	bot.Debug()->DebugLineOut(sc2::Point3D(min.x, min.y, maxZ + 0.2f), sc2::Point3D(max.x, max.y, maxZ + 0.2f), color);
 }
 
@@ -31,6 +37,9 @@ void Drawing::drawSquare(CCBot & bot, float x1, float y1, float x2, float y2, co
 		return;
 	}
 	const float maxZ = bot.Map().getHeight(x1, y1);
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugLineOut");
+	call.setElements(4);
 	bot.Debug()->DebugLineOut(sc2::Point3D(x1, y1, maxZ), sc2::Point3D(x1 + 1, y1, maxZ), color);
 	bot.Debug()->DebugLineOut(sc2::Point3D(x1, y1, maxZ), sc2::Point3D(x1, y1 + 1, maxZ), color);
 	bot.Debug()->DebugLineOut(sc2::Point3D(x1 + 1, y1 + 1, maxZ), sc2::Point3D(x1 + 1, y1, maxZ), color);
@@ -43,6 +52,8 @@ void Drawing::drawBox(CCBot & bot, float x1, float y1, float x2, float y2, const
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugBoxOut");
 	bot.Debug()->DebugBoxOut(sc2::Point3D(x1, y1, 2.0f + bot.Map().getHeight(x1,y1)), sc2::Point3D(x2, y2, 5.0f - bot.Map().getHeight(x1, y1) ), color);
 }
 
@@ -52,6 +63,8 @@ void Drawing::drawBox(CCBot & bot, const sc2::Point2D & min, const sc2::Point2D
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugBoxOut");
 	bot.Debug()->DebugBoxOut(sc2::Point3D(min.x, min.y, bot.Map().getHeight(min)+ 2.0f), sc2::Point3D(max.x, max.y, bot.Map().getHeight(min) - 5.0f), color);
 }
 
@@ -61,6 +74,8 @@ void Drawing::drawSphere(CCBot & bot, const sc2::Point2D & pos, float radius, co
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugSphereOut");
 	bot.Debug()->DebugSphereOut(sc2::Point3D(pos.x, pos.y, bot.Map().getHeight(pos)), radius, color);
 }
 
@@ -70,6 +85,8 @@ void Drawing::drawSphere(CCBot & bot, float x, float y, float radius, const sc2:
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugSphereOut");
 	bot.Debug()->DebugSphereOut(sc2::Point3D(x, y, bot.Map().getHeight(x,y)), radius, color);
 }
 
@@ -79,6 +96,8 @@ void Drawing::drawText(CCBot & bot, const sc2::Point2D & pos, const std::string
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugTextOut");
 	bot.Debug()->DebugTextOut(str, sc2::Point3D(pos.x, pos.y, bot.Map().getHeight(pos)), color);
 }
 
@@ -88,6 +107,8 @@ void Drawing::drawTextScreen(CCBot & bot, const sc2::Point2D & pos, const std::s
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(debugMutex);
+	ApiCall call(bot.ApiCalls(), "DebugTextOut");
 	bot.Debug()->DebugTextOut(str, pos, color,size);
 }
 
@@ -17,6 +17,7 @@ GameCommander::GameCommander(CCBot & bot)
 	, m_harassManager		(bot)
 	, m_combatCommander	 (bot)
 	, m_initialScoutSet	 (false)
+	, m_timedScanRequested(false)
 {
 
 }
@@ -27,20 +28,40 @@ void GameCommander::onStart()
 	m_scoutManager.onStart();
 	m_harassManager.onStart();
 	m_combatCommander.onStart();
-}
-
-void GameCommander::onFrame()
-{
-	m_timer.start();
 
-	handleDTdetections();
-	handleUnitAssignments();
-	m_productionManager.onFrame();
-	m_scoutManager.onFrame();
-	m_harassManager.onFrame();
-	m_combatCommander.onFrame(m_combatUnits);
-
-	drawDebugInterface();
+	m_bot.Scheduler().addTask("Assignments", 1, TaskPriority::Critical, 0.5, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Combat);
+		handleDTdetections();
+		handleUnitAssignments();
+		m_combatCommander.setCombatUnits(m_combatUnits);
+	});
+	m_bot.Scheduler().addTask("Production", 1, TaskPriority::High, 2.0, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Production);
+		m_productionManager.onFrame();
+	}, true);
+	m_bot.Scheduler().addTask("Scout", 1, TaskPriority::Normal, 0.5, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Combat);
+		m_scoutManager.onFrame();
+	}, true);
+	m_bot.Scheduler().addTask("Harass", 1, TaskPriority::High, 2.0, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Combat);
+		m_harassManager.onFrame();
+	});
+	m_bot.Scheduler().addTask("Squads", 1, TaskPriority::Normal, 1.0, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Combat);
+		m_combatCommander.updateSquads();
+	});
+	m_bot.Scheduler().addTask("Combat", 1, TaskPriority::Critical, 3.0, [this]()
+	{
+		m_bot.Actions()->setPriority(CommandPriority::Combat);
+		m_combatCommander.onFrame();
+		drawDebugInterface();
+	});
 }
 
 void GameCommander::drawDebugInterface()
@@ -60,11 +81,8 @@ void GameCommander::drawGameInformation(int x, int y)
 // assigns units to various managers
 void GameCommander::handleUnitAssignments()
 {
-	m_validUnits.clear();
 	m_combatUnits.clear();
 	m_harassUnits.clear();
-	// filter our units for those which are valid and usable
-	setValidUnits();
 
 	// set each type of unit
 	setScoutUnits();
@@ -80,14 +98,28 @@ bool GameCommander::isAssigned(const sc2::Unit * unit) const
 }
 
 // validates units as usable for distribution to various managers
-void GameCommander::setValidUnits()
+void GameCommander::setValidUnits(const UnitDeltas & deltas)
 {
-	// make sure the unit is completed and alive and usable
-	for (auto & unit : m_bot.UnitInfo().getUnits(Players::Self))
+	// only units we can currently see are usable
+	for (const auto & units : { &deltas.destroyed, &deltas.leftVision })
 	{
-		if (m_bot.GetUnit(unit->tag) && unit->is_alive && unit->last_seen_game_loop == m_bot.Observation()->GetGameLoop())
+		for (const auto & unit : *units)
 		{
-			m_validUnits.push_back(unit);
+			const auto it = std::find(m_validUnits.begin(), m_validUnits.end(), unit);
+			if (it != m_validUnits.end())
+			{
+				m_validUnits.erase(it);
+			}
+		}
+	}
+	for (const auto & units : { &deltas.created, &deltas.enteredVision })
+	{
+		for (const auto & unit : *units)
+		{
+			if (Util::GetPlayer(unit) == Players::Self && std::find(m_validUnits.begin(), m_validUnits.end(), unit) == m_validUnits.end())
+			{
+				m_validUnits.push_back(unit);
+			}
 		}
 	}
 }
@@ -262,14 +294,14 @@ void GameCommander::onUnitCreate(const sc2::Unit * unit)
 			}
 			else
 			{
-				std::map<const sc2::Unit *, UnitInfo> knownUnits = m_bot.UnitInfo().getUnitInfoMap(Players::Self);
+				const std::map<const sc2::Unit *, UnitInfo> & knownUnits = m_bot.UnitInfo().getUnitInfoMap(Players::Self);
 				if (knownUnits.find(unit) != knownUnits.end())
 				{
 					//We have seen this one already
 					return;
 				}
 
-				const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BUNKER }));
+				const UnitSpan Bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 				for (auto & b : Bunker)
 				{
 					if (b->build_progress==1.0f && b->cargo_space_taken != b->cargo_space_max)
@@ -303,6 +335,14 @@ void GameCommander::onUnitDestroy(const sc2::Unit * unit)
 	//_productionManager.onUnitDestroy(unit);
 }
 
+void GameCommander::onUnitDeltas(const UnitDeltas & deltas)
+{
+	setValidUnits(deltas);
+	m_productionManager.onUnitDeltas(deltas);
+	m_harassManager.onUnitDeltas(deltas);
+	m_combatCommander.onUnitDeltas(deltas);
+}
+
 void GameCommander::OnUnitEnterVision(const sc2::Unit * unit)
 {
 	if (unit->unit_type.ToType() == sc2::UNIT_TYPEID::TERRAN_LIBERATOR || unit->unit_type.ToType() == sc2::UNIT_TYPEID::TERRAN_BANSHEE || unit->unit_type.ToType() == sc2::UNIT_TYPEID::PROTOSS_COLOSSUS)
@@ -342,8 +382,10 @@ const ProductionManager & GameCommander::Production() const
 
 void GameCommander::handleDTdetections()
 {
-	if (m_bot.Observation()->GetGameLoop() == 5376)
+	// a step can span several game loops, so the loop itself may never be observed
+	if (!m_timedScanRequested && m_bot.Observation()->GetGameLoop() >= 5376)
 	{
+		m_timedScanRequested = true;
 		m_productionManager.requestScan();
 	}
 	if (m_DTdetections.size() > 0)
@@ -382,7 +424,7 @@ void GameCommander::handleDTdetections()
 		{
 			return;
 		}
-		const sc2::Units CommandCenters = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND));
+		const UnitSpan CommandCenters = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND);
 		for (const auto & unit : CommandCenters)
 		{
 			if (unit->build_progress == 1.0f)
@@ -390,7 +432,7 @@ void GameCommander::handleDTdetections()
 				if (unit->energy >= 50)
 				{
 					int nearbyUnits = 0;
-					for (const auto & unit : m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self))
+					for (const auto & unit : m_bot.UnitInfo().getUnits(Players::Self))
 					{
 						if (Util::IsCombatUnitType(unit->unit_type,m_bot) &&  Util::Dist(m_DTdetections.back().m_place, unit->pos) < scanRadius)
 						{
@@ -400,6 +442,7 @@ void GameCommander::handleDTdetections()
 					if (nearbyUnits > 5)
 					{
 						m_bot.Actions()->UnitCommand(unit, sc2::ABILITY_ID::EFFECT_SCAN, m_DTdetections.back().m_place);
+						m_bot.Abilities().onCast(unit, sc2::ABILITY_ID::EFFECT_SCAN);
 						m_productionManager.usedScan();
 						return;
 					}
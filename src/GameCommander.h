@@ -20,7 +20,6 @@ struct timePlace
 class GameCommander
 {
 	CCBot &				 m_bot;
-	Timer				   m_timer;
 
 	ProductionManager	   m_productionManager;
 	ScoutManager			m_scoutManager;
@@ -35,6 +34,7 @@ class GameCommander
 	std::vector<timePlace> m_DTdetections;
 
 	bool					m_initialScoutSet;
+	bool					m_timedScanRequested;
 
 	void assignUnit(const sc2::Unit * unit, std::vector<const sc2::Unit *> & units);
 	bool isAssigned(const sc2::Unit * unit) const;
@@ -44,10 +44,9 @@ public:
 	GameCommander(CCBot & bot);
 
 	void onStart();
-	void onFrame();
 
 	void handleUnitAssignments();
-	void setValidUnits();
+	void setValidUnits(const UnitDeltas & deltas);
 	void setScoutUnits();
 	void setHarassUnits();
 	void setCombatUnits();
@@ -62,6 +61,7 @@ public:
 	void onUnitCreate(const sc2::Unit * unit);
 	void OnBuildingConstructionComplete(const sc2::Unit * unit);
 	void onUnitDestroy(const sc2::Unit * unit);
+	void onUnitDeltas(const UnitDeltas & deltas);
 	void OnUnitEnterVision(const sc2::Unit * unit);
 	void OnDTdetected(const sc2::Point2D pos);
 
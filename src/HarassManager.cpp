@@ -4,10 +4,11 @@
 #include "pathPlaning.h"
 #include "Drawing.h"
 
-const int updateRatePathplaning = 10;
+// in game loops, so the escape path is replanned as often regardless of the step size
+const uint32_t updateRatePathplaning = 10;
 
 
-Hitsquad::Hitsquad(CCBot & bot, const sc2::Unit * medivac) : m_bot(bot), m_status(HarassStatus::Idle), m_medivac(medivac), m_pathPlanCounter(updateRatePathplaning+1)
+Hitsquad::Hitsquad(CCBot & bot, const sc2::Unit * medivac) : m_bot(bot), m_status(HarassStatus::Idle), m_medivac(medivac), m_lastPathPlan(0)
 {
 }
 
@@ -71,18 +72,21 @@ const int Hitsquad::getStatus() const
 	return m_status;
 }
 
-bool isDead(const sc2::Unit * unit)
+void Hitsquad::onUnitDeltas(const UnitDeltas & deltas)
 {
-	//!unit->buffs.empty() && unit->buffs.front().ToType()==sc2::BUFF_ID::
-	return !(unit->is_alive);
+	//Units leaving vision are not lost, the marines are inside the medivac most of the time
+	if (!deltas.destroyed.empty())
+	{
+		checkForCasualties(deltas.destroyed);
+	}
 }
 
-void Hitsquad::checkForCasualties()
+void Hitsquad::checkForCasualties(const sc2::Units & destroyed)
 {
-	//Last game loop check prevents units in bunker... but this is also true for in medivac
-	//m_marines.erase(std::remove_if(m_marines.begin(), m_marines.end(), [this](const sc2::Unit * unit) {return !(unit->is_alive && unit->last_seen_game_loop == m_bot.Observation()->GetGameLoop()); }), m_marines.end());
-	m_marines.erase(std::remove_if(m_marines.begin(), m_marines.end(), &isDead), m_marines.end());
-	if (m_medivac && !m_medivac->is_alive)
+	const auto isDead = [&destroyed](const sc2::Unit * unit) { return std::find(destroyed.begin(), destroyed.end(), unit) != destroyed.end(); };
+	m_marines.erase(std::remove_if(m_marines.begin(), m_marines.end(), isDead), m_marines.end());
+	m_doomedMarines.erase(std::remove_if(m_doomedMarines.begin(), m_doomedMarines.end(), isDead), m_doomedMarines.end());
+	if (m_medivac && isDead(m_medivac))
 	{
 		m_medivac = nullptr;
 		m_status = HarassStatus::Doomed;
@@ -93,7 +97,6 @@ void Hitsquad::checkForCasualties()
 
 void Hitsquad::harass(const BaseLocation * target)
 {
-	checkForCasualties();
 	switch (m_status)
 	{
 	case HarassStatus::Idle:
@@ -226,17 +229,17 @@ void Hitsquad::harass(const BaseLocation * target)
 		}
 		if (targetUnitsCanHitMedivac.size() > 0 || m_wayPoints.empty())
 		{
-			if (m_pathPlanCounter > updateRatePathplaning || m_wayPoints.empty())
+			const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+			if (gameLoop > m_lastPathPlan + updateRatePathplaning || m_wayPoints.empty())
 			{
 				while (!m_wayPoints.empty())
 				{
 					m_wayPoints.pop();
 				}
 				escapePathPlaning();
-				m_pathPlanCounter = 0;
+				m_lastPathPlan = gameLoop;
 			}
 		}
-		m_pathPlanCounter++;
 		if (Util::Dist(m_medivac->pos, m_wayPoints.front()) < 0.95f)
 		{
 			m_wayPoints.pop();
@@ -647,6 +650,14 @@ void HarassManager::onStart()
 {
 
 }
+void HarassManager::onUnitDeltas(const UnitDeltas & deltas)
+{
+	for (auto & hs : m_hitSquads)
+	{
+		hs.onUnitDeltas(deltas);
+	}
+}
+
 void HarassManager::onFrame()
 {
 	handleHitSquads();
@@ -4,6 +4,7 @@
 #include "BaseLocation.h"
 #include <queue>
 class CCBot;
+struct UnitDeltas;
 
 
 namespace HarassStatus
@@ -20,9 +21,9 @@ class Hitsquad
 	sc2::Units	m_marines;
 	sc2::Units	m_doomedMarines;
 	std::queue<sc2::Point2D> m_wayPoints;
-	int m_pathPlanCounter;
+	uint32_t m_lastPathPlan;
 
-	void checkForCasualties();
+	void checkForCasualties(const sc2::Units & destroyed);
 	const sc2::Unit * getTargetMarines(sc2::Units targets) const;
 	const bool manhattenMove(const BaseLocation * target);
 	sc2::Units getNearbyEnemyUnits() const;
@@ -40,6 +41,7 @@ public:
 	const sc2::Unit * getMedivac() const;
 	const int getStatus() const;
 	void harass(const BaseLocation *pos);
+	void onUnitDeltas(const UnitDeltas & deltas);
 };
 
 class ExeBomber
@@ -85,6 +87,7 @@ public:
 
 	void onStart();
 	void onFrame();
+	void onUnitDeltas(const UnitDeltas & deltas);
 
 	const bool needMedivac() const;
 	const bool needMarine() const;
@@ -20,7 +20,7 @@ MapTools::MapTools(CCBot & bot)
 	, m_width   (0)
 	, m_height  (0)
 	, m_maxZ	(0.0f)
-	, m_frame   (0)
+	, m_gameLoop(0)
 {
 
 }
@@ -32,9 +32,9 @@ void MapTools::onStart()
 
 	m_walkable	   = vvb(m_width, std::vector<bool>(m_height, true));
 	m_buildable	  = vvb(m_width, std::vector<bool>(m_height, false));
+	m_nearResources  = vvb(m_width, std::vector<bool>(m_height, false));
 	m_ramp = vvb(m_width, std::vector<bool>(m_height, false));
-	m_lastSeen	   = vvi(m_width, std::vector<int>(m_height, 0));
-	m_sectorNumber   = vvi(m_width, std::vector<int>(m_height, 0));
+	m_lastSeen	   = vvi(m_width, std::vector<int>(m_height, -1));
 	m_terrainHeight  = vvf(m_width, std::vector<float>(m_height, 0.0f));
 
 	// Set the boolean grid data from the Map
@@ -51,6 +51,23 @@ void MapTools::onStart()
 	for (const auto & unit : m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Neutral))
 	{
 		m_maxZ = std::max(unit->pos.z, m_maxZ);
+		if (!Util::IsMineral(unit) && !Util::IsGeyser(unit))
+		{
+			continue;
+		}
+		// the footprint of the resource grown by 3 tiles in every direction
+		const float halfWidth = Util::IsMineral(unit) ? 1.0f : 1.5f;
+		const float halfHeight = Util::IsMineral(unit) ? 0.5f : 1.5f;
+		for (int x = (int)std::floor(unit->pos.x - halfWidth) - 3; x < (int)std::ceil(unit->pos.x + halfWidth) + 3; ++x)
+		{
+			for (int y = (int)std::floor(unit->pos.y - halfHeight) - 3; y < (int)std::ceil(unit->pos.y + halfHeight) + 3; ++y)
+			{
+				if (isValid(x, y))
+				{
+					m_nearResources[x][y] = true;
+				}
+			}
+		}
 	}
 
 	computeConnectivity();
@@ -58,7 +75,23 @@ void MapTools::onStart()
 
 void MapTools::onFrame()
 {
-	m_frame++;
+	ProfileScope profile(m_bot.Profiler(), "MapTools");
+	m_gameLoop = static_cast<int>(m_bot.Observation()->GetGameLoop());
+
+	std::unique_lock<std::mutex> lock(m_distanceMapMutex);
+	for (auto it = m_pendingMaps.begin(); it != m_pendingMaps.end();)
+	{
+		if (ThreadPool::isReady(it->second))
+		{
+			_allMaps[it->first] = std::make_shared<const DistanceMap>(it->second.get());
+			it = m_pendingMaps.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	lock.unlock();
 
 	for (int x=0; x<m_width; ++x)
 	{
@@ -66,7 +99,7 @@ void MapTools::onFrame()
 		{
 			if (isVisible(sc2::Point2D((float)x, (float)y)))
 			{
-				m_lastSeen[x][y] = m_frame;
+				m_lastSeen[x][y] = m_gameLoop;
 			}
 		}
 	}
@@ -74,6 +107,8 @@ void MapTools::onFrame()
 
 void MapTools::computeConnectivity()
 {
+	m_sectorNumber = vvi(m_width, std::vector<int>(m_height, 0));
+
 	// the fringe data structe we will use to do our BFS searches
 	std::vector<sc2::Point2D> fringe;
 	fringe.reserve(m_width*m_height);
@@ -135,6 +170,11 @@ bool MapTools::isVisible(const sc2::Point2D & pos) const
 	return m_bot.Observation()->GetVisibility(pos) == sc2::Visibility::Visible;
 }
 
+bool MapTools::wasSeenThisFrame(int x, int y) const
+{
+	return isValid(x, y) && m_lastSeen[x][y] == m_gameLoop;
+}
+
 bool MapTools::isPowered(const sc2::Point2D & pos) const
 {
 	for (const auto & powerSource : m_bot.Observation()->GetPowerSources())
@@ -160,25 +200,72 @@ float MapTools::terrainHeight(float x, float y) const
 
 int MapTools::getGroundDistance(const sc2::Point2D & src, const sc2::Point2D & dest) const
 {
-	if (_allMaps.size() > 50)
 	{
-		_allMaps.clear();
+		std::lock_guard<std::mutex> lock(m_distanceMapMutex);
+		if (_allMaps.size() > 50)
+		{
+			_allMaps.clear();
+		}
 	}
 
-	return getDistanceMap(dest).getDistance(src);
+	return getDistanceMap(dest)->getDistance(src);
 }
 
-const DistanceMap & MapTools::getDistanceMap(const sc2::Point2D & tile) const
+std::shared_ptr<const DistanceMap> MapTools::getDistanceMap(const sc2::Point2D & tile) const
 {
 	std::pair<int, int> intTile((int)tile.x, (int)tile.y);
+	{
+		std::lock_guard<std::mutex> lock(m_distanceMapMutex);
+		const auto cached = _allMaps.find(intTile);
+		if (cached != _allMaps.end())
+		{
+			return cached->second;
+		}
+		// do not wait for an unfinished job, we might be running on the thread that has to do it
+		const auto pending = m_pendingMaps.find(intTile);
+		if (pending != m_pendingMaps.end() && ThreadPool::isReady(pending->second))
+		{
+			std::shared_ptr<const DistanceMap> & map = _allMaps[intTile];
+			map = std::make_shared<const DistanceMap>(pending->second.get());
+			m_pendingMaps.erase(pending);
+			return map;
+		}
+	}
+
+	// the search runs without the lock, the other squads keep reading the cache meanwhile. The walkable grid
+	// does not change after onStart
+	std::shared_ptr<DistanceMap> map = std::make_shared<DistanceMap>();
+	map->computeDistanceMap(m_walkable, tile);
 
-	if (_allMaps.find(intTile) == _allMaps.end())
+	// another thread may have published the same map in the meantime, everybody gets the same one
+	std::lock_guard<std::mutex> lock(m_distanceMapMutex);
+	return _allMaps.emplace(intTile, map).first->second;
+}
+
+void MapTools::requestDistanceMap(const sc2::Point2D & tile) const
+{
+	std::lock_guard<std::mutex> lock(m_distanceMapMutex);
+	std::pair<int, int> intTile((int)tile.x, (int)tile.y);
+
+	if (!isValid(intTile.first, intTile.second) || _allMaps.find(intTile) != _allMaps.end() || m_pendingMaps.find(intTile) != m_pendingMaps.end())
 	{
-		_allMaps[intTile] = DistanceMap();
-		_allMaps[intTile].computeDistanceMap(m_bot, tile);
+		return;
 	}
+	// the walkable grid does not change after onStart
+	const std::vector<std::vector<bool>> & walkable = m_walkable;
+	ModuleProfiler & profiler = m_bot.Profiler();
+	m_pendingMaps[intTile] = m_bot.Threads().submit([&walkable, &profiler, tile]()
+	{
+		ProfileScope profile(profiler, "DistanceMap", "job");
+		DistanceMap map;
+		map.computeDistanceMap(walkable, tile);
+		return map;
+	});
+}
 
-	return _allMaps[intTile];
+const std::vector<std::vector<bool>> & MapTools::getWalkableGrid() const
+{
+	return m_walkable;
 }
 
 int MapTools::getSectorNumber(int x, int y) const
@@ -236,9 +323,14 @@ bool MapTools::isBuildable(int x, int y) const
 	return m_buildable[x][y];
 }
 
-bool MapTools::canBuildTypeAtPosition(int x, int y, sc2::UnitTypeID type) const
+bool MapTools::isNearResources(int x, int y) const
 {
-	return m_bot.Query()->Placement(m_bot.Data(type).buildAbility, sc2::Point2D((float)x, (float)y));
+	if (!isValid(x, y))
+	{
+		return false;
+	}
+
+	return m_nearResources[x][y];
 }
 
 bool MapTools::isBuildable(const sc2::Point2D & tile) const
@@ -281,21 +373,22 @@ int MapTools::height() const
 	return m_height;
 }
 
-const std::vector<sc2::Point2D> & MapTools::getClosestTilesTo(const sc2::Point2D & pos) const
+std::shared_ptr<const std::vector<sc2::Point2D>> MapTools::getClosestTilesTo(const sc2::Point2D & pos) const
 {
-	return getDistanceMap(pos).getSortedTiles();
+	const std::shared_ptr<const DistanceMap> map = getDistanceMap(pos);
+	return std::shared_ptr<const std::vector<sc2::Point2D>>(map, &map->getSortedTiles());
 }
 
 const sc2::Point2D MapTools::getClosestWalkableTo(const sc2::Point2D & pos) const
 {
 	// get the precomputed vector of tile positions which are sorted closes to this location
-	auto & closestToPos = getClosestTilesTo(pos);
+	const auto closestToPos = getClosestTilesTo(pos);
 
 
 	// iterate through the list until we've found a suitable location
-	for (size_t i(0); i < closestToPos.size(); ++i)
+	for (size_t i(0); i < closestToPos->size(); ++i)
 	{
-		auto & pos = closestToPos[i];
+		auto & pos = (*closestToPos)[i];
 
 		if (isWalkable(pos))
 		{
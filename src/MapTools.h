@@ -2,6 +2,10 @@
 
 #include <vector>
 
+#include <future>
+#include <memory>
+#include <mutex>
+
 #include "sc2api/sc2_api.h"
 #include "DistanceMap.h"
 
@@ -13,21 +17,25 @@ class MapTools
 	int	 m_width;
 	int	 m_height;
 	float   m_maxZ;
-	int	 m_frame;
+	int	 m_gameLoop;		// game loop of the last onFrame, the bot may step several loops at once
 	
 
-	// a cache of already computed distance maps, which is mutable since it only acts as a cache
-	mutable std::map<std::pair<int, int>, DistanceMap>   _allMaps;   
+	// a cache of already computed distance maps, which is mutable since it only acts as a cache.
+	// Squads on other threads keep the maps they got while the cache evicts them.
+	mutable std::map<std::pair<int, int>, std::shared_ptr<const DistanceMap>>   _allMaps;   
+	// distance maps computed in the background, they move to the cache once done
+	mutable std::map<std::pair<int, int>, std::future<DistanceMap>>   m_pendingMaps;
+	// squads ask for distances from several threads, it only guards the two maps above and is never held during a search
+	mutable std::mutex				m_distanceMapMutex;
 
 	std::vector<std::vector<bool>>  m_walkable;		 // whether a tile is buildable (includes static resources)
 	std::vector<std::vector<bool>>  m_buildable;		// whether a tile is buildable (includes static resources)
+	std::vector<std::vector<bool>>  m_nearResources;	// town halls can not be placed within 3 tiles of minerals and geysers
 	std::vector<std::vector<bool>>  m_ramp;   // whether a depot is buildable on a tile (illegal within 3 tiles of static resource)
-	std::vector<std::vector<int>>   m_lastSeen;		 // the last time any of our units has seen this position on the map
+	std::vector<std::vector<int>>   m_lastSeen;		 // the game loop any of our units has last seen this position on the map, -1 if never
 	std::vector<std::vector<int>>   m_sectorNumber;	 // connectivity sector number, two tiles are ground connected if they have the same number
 	std::vector<std::vector<float>> m_terrainHeight;		// height of the map at x+0.5, y+0.5
 	
-	void computeConnectivity();
-
 		
 	bool isNextToRamp(int x, int y) const;
 
@@ -39,6 +47,8 @@ public:
 
 	void	onStart();
 	void	onFrame();
+	// fills the sector numbers from the walkable grid, onStart does it. Public for the micro benchmarks
+	void	computeConnectivity();
 
 	int	 width() const;
 	int	 height() const;
@@ -51,9 +61,12 @@ public:
 	bool	isPowered(const sc2::Point2D & pos) const;
 	bool	isExplored(const sc2::Point2D & pos) const;
 	bool	isVisible(const sc2::Point2D & pos) const;
-	bool	canBuildTypeAtPosition(int x, int y, sc2::UnitTypeID type) const;
+	bool	wasSeenThisFrame(int x, int y) const;
 
-	const   DistanceMap & getDistanceMap(const sc2::Point2D & tile) const;
+	std::shared_ptr<const DistanceMap> getDistanceMap(const sc2::Point2D & tile) const;
+	// starts computing the distance map in the background, so a later getDistanceMap does not have to wait for it
+	void	requestDistanceMap(const sc2::Point2D & tile) const;
+	const std::vector<std::vector<bool>> & getWalkableGrid() const;
 	int	 getGroundDistance(const sc2::Point2D & src, const sc2::Point2D & dest) const;
 	bool	isConnected(int x1, int y1, int x2, int y2) const;
 	bool	isConnected(const sc2::Point2D & from, const sc2::Point2D & to) const;
@@ -62,6 +75,7 @@ public:
 	
 	bool	isBuildable(const sc2::Point2D & pos) const;
 	bool	isBuildable(int x, int y) const;
+	bool	isNearResources(int x, int y) const;
 	bool	isDepotBuildableTile(const sc2::Point2D & pos) const;
 	
 	sc2::Point2D getLeastRecentlySeenPosition() const;
@@ -70,7 +84,8 @@ public:
 
 	sc2::Point2D getWallPosition(sc2::UnitTypeID type) const;
 	// returns a list of all tiles on the map, sorted by 4-direcitonal walk distance from the given position
-	const std::vector<sc2::Point2D> & getClosestTilesTo(const sc2::Point2D & pos) const;
+	// the tiles stay valid as long as the pointer is kept
+	std::shared_ptr<const std::vector<sc2::Point2D>> getClosestTilesTo(const sc2::Point2D & pos) const;
 	const sc2::Point2D getClosestWalkableTo(const sc2::Point2D & pos) const;
 	const sc2::Point2D getClosestBorderPoint(sc2::Point2D pos,int margin) const;
 	const bool hasPocketBase() const;
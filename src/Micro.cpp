@@ -264,18 +264,16 @@ void Micro::SmartKiteTarget(const sc2::Unit * rangedUnit, const sc2::Unit * targ
 	}
 	else
 	{
+		//Stepping back has to be timed with the weapon cooldown
+		bot.requestFineStep();
 		auto buffs = rangedUnit->buffs;
 		if (rangedUnit->health == rangedUnit->health_max && (buffs.empty() || std::find(buffs.begin(), buffs.end(), sc2::BUFF_ID::STIMPACK) == buffs.end()))
 		{
-			sc2::AvailableAbilities abilities = bot.Query()->GetAbilitiesForUnit(rangedUnit);
-
-			for (const auto & ability : abilities.abilities)
+			if (bot.Abilities().isReady(rangedUnit, sc2::ABILITY_ID::EFFECT_STIM))
 			{
-				if (ability.ability_id == sc2::ABILITY_ID::EFFECT_STIM)
-				{
-					bot.Actions()->UnitCommand(rangedUnit, sc2::ABILITY_ID::EFFECT_STIM);
-					return;
-				}
+				bot.Actions()->UnitCommand(rangedUnit, sc2::ABILITY_ID::EFFECT_STIM);
+				bot.Abilities().onCast(rangedUnit, sc2::ABILITY_ID::EFFECT_STIM);
+				return;
 			}
 		}
 		//A normed vector to the target
@@ -357,32 +355,23 @@ void Micro::SmartAbility(const sc2::Unit * unit, const sc2::AbilityID & abilityI
 void Micro::SmartCDAbility(const sc2::Unit * builder, const sc2::AbilityID & abilityID, CCBot & bot, bool queue)
 {
 	BOT_ASSERT(builder != nullptr, "Builder is null");
-	sc2::AvailableAbilities abilities = bot.Query()->GetAbilitiesForUnit(builder);
-
-	for (const auto & ability : abilities.abilities)
+	if (bot.Abilities().isReady(builder, abilityID))
 	{
-		if (ability.ability_id == abilityID)
-		{
-			bot.Actions()->UnitCommand(builder, abilityID,queue);
-			return;
-		}
+		bot.Actions()->UnitCommand(builder, abilityID,queue);
+		bot.Abilities().onCast(builder, abilityID);
 	}
 }
 
 void Micro::SmartCDAbility(sc2::Units units, const sc2::AbilityID & abilityID, CCBot & bot, bool queue)
 {
 	sc2::Units targets;
+	bot.Abilities().request(units);
 	for (const auto & unit : units)
 	{
-		sc2::AvailableAbilities abilities = bot.Query()->GetAbilitiesForUnit(unit);
-
-		for (const auto & ability : abilities.abilities)
+		if (bot.Abilities().isReady(unit, abilityID))
 		{
-			if (ability.ability_id == abilityID)
-			{
-				targets.push_back(unit);
-				continue;
-			}
+			targets.push_back(unit);
+			bot.Abilities().onCast(unit, abilityID);
 		}
 	}
 	bot.Actions()->UnitCommand(targets, abilityID,queue);
@@ -392,22 +381,26 @@ void Micro::SmartCDAbility(sc2::Units units, const sc2::AbilityID & abilityID, C
 void Micro::SmartStim(sc2::Units units, CCBot & bot, bool queue)
 {
 	sc2::Units targets;
+	sc2::Units candidates;
 	for (const auto & unit : units)
 	{
 		auto buffs = unit->buffs;
 		if (unit->health == unit->health_max && (buffs.empty() || std::find(buffs.begin(), buffs.end(), sc2::BUFF_ID::STIMPACK) == buffs.end()))
 		{
-			sc2::AvailableAbilities abilities = bot.Query()->GetAbilitiesForUnit(unit);
-
-			for (const auto & ability : abilities.abilities)
-			{
-				if (ability.ability_id == sc2::ABILITY_ID::EFFECT_STIM)
-				{
-					targets.push_back(unit);
-					continue;
-				}
-			}
+			candidates.push_back(unit);
+		}
+	}
+	for (const auto & unit : candidates)
+	{
+		if (bot.Abilities().isReady(unit, sc2::ABILITY_ID::EFFECT_STIM))
+		{
+			targets.push_back(unit);
+			bot.Abilities().onCast(unit, sc2::ABILITY_ID::EFFECT_STIM);
 		}
 	}
+	if (!targets.empty())
+	{
+		bot.requestFineStep();
+	}
 	bot.Actions()->UnitCommand(targets, sc2::ABILITY_ID::EFFECT_STIM);
 }
\ No newline at end of file
@@ -29,7 +29,7 @@ void MicroManager::execute(const SquadOrder & inputOrder)
 				if (Util::IsCombatUnitType(unit->unit_type, m_bot))
 				{
 					Micro::SmartAttackMove(unit, pos, m_bot);
-					const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BUNKER }));
+					const UnitSpan Bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 					if (Bunker.size() > 0)
 					{
 						for (auto & b : Bunker)
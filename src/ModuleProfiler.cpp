@@ -0,0 +1,334 @@
+#include "ModuleProfiler.h"
+#include "CCBot.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+const size_t histogramBuckets = 200;
+const double bucketGrowth = 1.1;
+
+// the path of every open zone of this thread, innermost last
+thread_local std::vector<std::string> openZones;
+
+namespace
+{
+	size_t getBucket(double ms)
+	{
+		const double us = ms * 1000.0;
+		if (us <= 1.0)
+		{
+			return 0;
+		}
+		return std::min(histogramBuckets - 1, static_cast<size_t>(std::ceil(std::log(us) / std::log(bucketGrowth))));
+	}
+
+	std::string escape(const std::string & text)
+	{
+		std::string escaped;
+		for (const char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+}
+
+ProfileZone::ProfileZone()
+	: histogram(histogramBuckets, 0)
+	, steps(0)
+	, calls(0)
+	, totalMs(0.0)
+	, maxMs(0.0)
+	, lastMs(0.0)
+	, stepMs(0.0)
+	, stepCalls(0)
+	, allocations(0)
+	, bytes(0)
+	, lastAllocations(0)
+	, lastBytes(0)
+	, stepAllocations(0)
+	, stepBytes(0)
+{
+
+}
+
+void ProfileZone::addStep()
+{
+	++histogram[getBucket(stepMs)];
+	++steps;
+	calls += stepCalls;
+	totalMs += stepMs;
+	maxMs = std::max(maxMs, stepMs);
+	lastMs = stepMs;
+	stepMs = 0.0;
+	stepCalls = 0;
+	allocations += stepAllocations;
+	bytes += stepBytes;
+	lastAllocations = stepAllocations;
+	lastBytes = stepBytes;
+	stepAllocations = 0;
+	stepBytes = 0;
+}
+
+double ProfileZone::percentile(double p) const
+{
+	if (steps == 0)
+	{
+		return 0.0;
+	}
+	const size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(p * steps)));
+	size_t count = 0;
+	for (size_t i = 0; i < histogram.size(); ++i)
+	{
+		count += histogram[i];
+		if (count >= rank)
+		{
+			return std::min(maxMs, std::pow(bucketGrowth, static_cast<double>(i)) / 1000.0);
+		}
+	}
+	return maxMs;
+}
+
+ModuleProfiler::ModuleProfiler(CCBot & bot)
+	: m_bot(bot)
+	, m_enabled(false)
+	, m_slowestTracedStep(0.0)
+{
+
+}
+
+void ModuleProfiler::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+bool ModuleProfiler::isEnabled() const
+{
+	return m_enabled;
+}
+
+void ModuleProfiler::setTracing(bool tracing)
+{
+	m_trace.setEnabled(tracing);
+}
+
+TraceWriter & ModuleProfiler::getTrace()
+{
+	return m_trace;
+}
+
+void ModuleProfiler::record(const std::string & zone, double ms, size_t allocations, size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ProfileZone & profileZone = m_zones[zone];
+	profileZone.stepMs += ms;
+	++profileZone.stepCalls;
+	profileZone.stepAllocations += allocations;
+	profileZone.stepBytes += bytes;
+}
+
+// closes the last step, call it before the zones of the next one open
+void ModuleProfiler::onFrame()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	double stepMs = 0.0;
+	for (auto & zone : m_zones)
+	{
+		if (zone.second.stepCalls > 0)
+		{
+			if (zone.first == "Step")
+			{
+				stepMs = zone.second.stepMs;
+			}
+			zone.second.addStep();
+		}
+	}
+	lock.unlock();
+	m_bot.ApiCalls().onFrame();
+
+	const int slowStep = m_bot.Config().TraceSlowStepMs;
+	if (m_trace.isEnabled() && slowStep > 0 && stepMs > slowStep && stepMs > m_slowestTracedStep)
+	{
+		m_slowestTracedStep = stepMs;
+		writeTrace(m_bot.Config().WriteDir + "trace_" + std::to_string(m_bot.Observation()->GetGameLoop()) + ".json");
+	}
+}
+
+void ModuleProfiler::drawInfo() const
+{
+	if (!m_bot.Config().DrawModuleTimers)
+	{
+		return;
+	}
+
+	std::stringstream ss;
+	writeTable(ss);
+	Drawing::drawTextScreen(m_bot, sc2::Point2D(0.3f, 0.05f), ss.str());
+}
+
+void ModuleProfiler::writeTable(std::ostream & out) const
+{
+	const std::ios::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(2);
+	const bool allocations = AllocationTracker::isEnabled();
+	out << "Zone: last p50 p95 p99 max (ms)" << (allocations ? ", allocations and KB: last mean" : "") << "\n";
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const auto & zone : m_zones)
+	{
+		const size_t depth = std::count(zone.first.begin(), zone.first.end(), '/');
+		const size_t nameStart = zone.first.rfind('/');
+		out << std::string(2 * depth, ' ') << (nameStart == std::string::npos ? zone.first : zone.first.substr(nameStart + 1)) << ": ";
+		out << zone.second.lastMs << " " << zone.second.percentile(0.5) << " " << zone.second.percentile(0.95) << " " << zone.second.percentile(0.99) << " " << zone.second.maxMs;
+		if (allocations)
+		{
+			const double steps = static_cast<double>(std::max<size_t>(1, zone.second.steps));
+			out << ", " << zone.second.lastAllocations << " " << zone.second.allocations / steps << " " << zone.second.lastBytes / 1024.0 << " " << zone.second.bytes / steps / 1024.0;
+		}
+		out << "\n";
+	}
+	out.flags(flags);
+	out.precision(precision);
+	m_bot.ApiCalls().writeTable(out, 10);
+}
+
+void ModuleProfiler::writeReport(const std::string & fileName) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream json(fileName + ".json");
+	std::ofstream csv(fileName + ".csv");
+	if (!json || !csv)
+	{
+		std::cout << "Unable to write the profile to " << fileName << std::endl;
+		return;
+	}
+
+	json << "{\n\t\"zones\": [";
+	csv << "zone,steps,calls,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,allocs_per_step,bytes_per_step\n";
+	bool first = true;
+	for (const auto & zone : m_zones)
+	{
+		const ProfileZone & z = zone.second;
+		const double mean = z.steps > 0 ? z.totalMs / z.steps : 0.0;
+		const double allocations = z.steps > 0 ? static_cast<double>(z.allocations) / z.steps : 0.0;
+		const double bytes = z.steps > 0 ? static_cast<double>(z.bytes) / z.steps : 0.0;
+		json << (first ? "\n" : ",\n") << "\t\t{ \"zone\": \"" << escape(zone.first) << "\", \"steps\": " << z.steps << ", \"calls\": " << z.calls
+			<< ", \"mean_ms\": " << mean << ", \"p50_ms\": " << z.percentile(0.5) << ", \"p95_ms\": " << z.percentile(0.95)
+			<< ", \"p99_ms\": " << z.percentile(0.99) << ", \"max_ms\": " << z.maxMs << ", \"allocs_per_step\": " << allocations
+			<< ", \"bytes_per_step\": " << bytes << " }";
+		csv << "\"" << zone.first << "\"," << z.steps << "," << z.calls << "," << mean << "," << z.percentile(0.5) << ","
+			<< z.percentile(0.95) << "," << z.percentile(0.99) << "," << z.maxMs << "," << allocations << "," << bytes << "\n";
+		first = false;
+	}
+	json << "\n\t]";
+
+	// per step over the game
+	if (m_bot.ApiCalls().isEnabled())
+	{
+		const double steps = static_cast<double>(std::max<size_t>(1, m_bot.ApiCalls().getSteps()));
+		json << ",\n\t\"api_calls\": [";
+		first = true;
+		for (const auto & site : m_bot.ApiCalls().getSites())
+		{
+			const ApiCallSite & s = site.second;
+			json << (first ? "\n" : ",\n") << "\t\t{ \"zone\": \"" << escape(site.first.first) << "\", \"function\": \"" << escape(site.first.second)
+				<< "\", \"calls\": " << s.calls << ", \"calls_per_step\": " << s.calls / steps << ", \"ms_per_step\": " << s.totalMs / steps
+				<< ", \"max_step_ms\": " << s.maxMs << ", \"elements_per_step\": " << s.elements / steps << " }";
+			first = false;
+		}
+		json << "\n\t]";
+	}
+	json << "\n}\n";
+}
+
+void ModuleProfiler::writeCounts(std::ostream & out) const
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto & zone : m_zones)
+		{
+			out << "allocations\t" << zone.first << "\t" << zone.second.allocations << "\n";
+		}
+	}
+	std::map<std::pair<std::string, std::string>, size_t> calls;
+	for (const auto & site : m_bot.ApiCalls().getSites())
+	{
+		calls[site.first] = site.second.calls;
+	}
+	for (const auto & site : calls)
+	{
+		out << "api\t" << site.first.first << "\t" << site.first.second << "\t" << site.second << "\n";
+	}
+}
+
+void ModuleProfiler::writeTrace(const std::string & fileName) const
+{
+	if (!m_trace.write(fileName))
+	{
+		std::cout << "Unable to write the trace to " << fileName << std::endl;
+	}
+}
+
+const std::string & ModuleProfiler::currentZone()
+{
+	static const std::string none;
+	return openZones.empty() ? none : openZones.back();
+}
+
+ProfileScope::ProfileScope(ModuleProfiler & profiler, const std::string & name, const char * category)
+	: m_profiler(profiler.isEnabled() ? &profiler : nullptr)
+	, m_category(category)
+	, m_start(0)
+	, m_allocations(0)
+	, m_bytes(0)
+{
+	if (!m_profiler)
+	{
+		return;
+	}
+	openZones.push_back(openZones.empty() ? name : openZones.back() + "/" + name);
+	m_start = m_profiler->getTrace().now();
+	m_allocations = AllocationTracker::threadAllocations();
+	m_bytes = AllocationTracker::threadBytes();
+	m_timer.start();
+}
+
+ProfileScope::~ProfileScope()
+{
+	if (!m_profiler)
+	{
+		return;
+	}
+	const double ms = m_timer.getElapsedTimeInMilliSec();
+	const size_t allocations = AllocationTracker::threadAllocations() - m_allocations;
+	const size_t bytes = AllocationTracker::threadBytes() - m_bytes;
+	const std::string & zone = openZones.back();
+	m_profiler->record(zone, ms, allocations, bytes);
+	const size_t nameStart = zone.rfind('/');
+	m_profiler->getTrace().add(nameStart == std::string::npos ? zone : zone.substr(nameStart + 1), m_category, m_start, static_cast<uint64_t>(ms * 1000.0));
+	openZones.pop_back();
+}
+
+ProfileContext::ProfileContext(const ModuleProfiler & profiler, const std::string & zone)
+	: m_active(profiler.isEnabled() && !zone.empty())
+{
+	if (m_active)
+	{
+		openZones.push_back(zone);
+	}
+}
+
+ProfileContext::~ProfileContext()
+{
+	if (m_active)
+	{
+		openZones.pop_back();
+	}
+}
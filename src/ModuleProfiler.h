@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Common.h"
+#include "Timer.hpp"
+#include "TraceWriter.h"
+#include <mutex>
+
+class CCBot;
+
+// the times of one zone over the steps it ran in. A step counts the sum of all its calls.
+// Bucket i of the histogram holds times up to 1.1^i microseconds.
+struct ProfileZone
+{
+	std::vector<uint32_t>	histogram;
+	size_t					steps;
+	size_t					calls;
+	double					totalMs;
+	double					maxMs;
+	double					lastMs;
+	double					stepMs;
+	size_t					stepCalls;
+	// counted while TrackAllocations is set, a zone includes the zones inside it
+	size_t					allocations;
+	size_t					bytes;
+	size_t					lastAllocations;
+	size_t					lastBytes;
+	size_t					stepAllocations;
+	size_t					stepBytes;
+
+	ProfileZone();
+
+	void	addStep();
+	double	percentile(double p) const;
+};
+
+// collects the ProfileScopes into per zone histograms. Zones nest and are named by their path, e.g. Step/Combat/Squad MainAttack.
+// It only records while DrawModuleTimers, WriteProfile, WriteTrace, ProfileApiCalls or TrackAllocations is set. The report and the trace go to WriteDir at game end,
+// a trace also whenever a step is slower than TraceSlowStepMs and all steps before.
+class ModuleProfiler
+{
+	CCBot &								m_bot;
+	bool								m_enabled;
+	std::map<std::string, ProfileZone>	m_zones;
+	mutable std::mutex					m_mutex;
+	TraceWriter							m_trace;
+	double								m_slowestTracedStep;
+
+public:
+
+	ModuleProfiler(CCBot & bot);
+
+	void	setEnabled(bool enabled);
+	bool	isEnabled() const;
+	void	setTracing(bool tracing);
+	TraceWriter & getTrace();
+	void	record(const std::string & zone, double ms, size_t allocations = 0, size_t bytes = 0);
+	void	onFrame();
+	void	drawInfo() const;
+	// one zone per line, indented by depth, then the worst API call sites
+	void	writeTable(std::ostream & out) const;
+	// writes fileName.json and fileName.csv
+	void	writeReport(const std::string & fileName) const;
+	// the allocations of every zone and the calls of every API call site, one per line and sorted. They do not depend
+	// on the timing, so two runs of the same record write the same unless the bot changed
+	void	writeCounts(std::ostream & out) const;
+	void	writeTrace(const std::string & fileName) const;
+
+	// the zone the calling thread is in, empty outside of all zones
+	static const std::string & currentZone();
+};
+
+// times its lifetime as a zone inside the current zone of this thread. The category shows in the trace:
+// zone for bot code, api for round trips to the game and job for the thread pool.
+class ProfileScope
+{
+	ModuleProfiler *	m_profiler;
+	const char *		m_category;
+	Timer				m_timer;
+	uint64_t			m_start;
+	size_t				m_allocations;	// of this thread when the zone opened
+	size_t				m_bytes;
+
+public:
+
+	ProfileScope(ModuleProfiler & profiler, const std::string & name, const char * category = "zone");
+	~ProfileScope();
+
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope & operator=(const ProfileScope &) = delete;
+};
+
+// continues a zone of another thread, so jobs on the thread pool nest where they were submitted
+class ProfileContext
+{
+	bool	m_active;
+
+public:
+
+	ProfileContext(const ModuleProfiler & profiler, const std::string & zone);
+	~ProfileContext();
+
+	ProfileContext(const ProfileContext &) = delete;
+	ProfileContext & operator=(const ProfileContext &) = delete;
+};
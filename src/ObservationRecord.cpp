@@ -0,0 +1,495 @@
+#include "ObservationRecord.h"
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+	// the fields of every type that is not written as it is in memory. The same function writes and reads,
+	// so the two cannot disagree.
+	template <typename Archive> void serialize(Archive & ar, sc2::Unit & unit);
+	template <typename Archive> void serialize(Archive & ar, sc2::Weapon & weapon);
+	template <typename Archive> void serialize(Archive & ar, sc2::UnitTypeData & data);
+	template <typename Archive> void serialize(Archive & ar, sc2::AbilityData & data);
+	template <typename Archive> void serialize(Archive & ar, sc2::UpgradeData & data);
+	template <typename Archive> void serialize(Archive & ar, sc2::BuffData & data);
+	template <typename Archive> void serialize(Archive & ar, sc2::EffectData & data);
+	template <typename Archive> void serialize(Archive & ar, sc2::Effect & effect);
+	template <typename Archive> void serialize(Archive & ar, sc2::AvailableAbilities & abilities);
+	template <typename Archive> void serialize(Archive & ar, sc2::ImageData & image);
+	template <typename Archive> void serialize(Archive & ar, sc2::GameInfo & info);
+	template <typename Archive> void serialize(Archive & ar, RecordedEvent & event);
+	template <typename Archive> void serialize(Archive & ar, RecordedAction & action);
+	template <typename Archive> void serialize(Archive & ar, RecordedStep & step);
+	template <typename Archive> void serialize(Archive & ar, RecordedGame & game);
+
+	class Encoder
+	{
+	public:
+
+		std::string data;
+
+		template <typename T>
+		typename std::enable_if<std::is_trivially_copyable<T>::value>::type operator()(T & value)
+		{
+			data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		typename std::enable_if<!std::is_trivially_copyable<T>::value>::type operator()(T & value)
+		{
+			serialize(*this, value);
+		}
+
+		void operator()(std::string & value)
+		{
+			uint32_t size = static_cast<uint32_t>(value.size());
+			(*this)(size);
+			data.append(value);
+		}
+
+		template <typename T>
+		void operator()(std::vector<T> & values)
+		{
+			uint32_t size = static_cast<uint32_t>(values.size());
+			(*this)(size);
+			for (auto & value : values)
+			{
+				(*this)(value);
+			}
+		}
+
+		template <typename K, typename V>
+		void operator()(std::map<K, V> & values)
+		{
+			uint32_t size = static_cast<uint32_t>(values.size());
+			(*this)(size);
+			for (auto & value : values)
+			{
+				K key = value.first;
+				(*this)(key);
+				(*this)(value.second);
+			}
+		}
+
+		template <typename... T>
+		void fields(T &... values)
+		{
+			const int expand[] = { 0, ((*this)(values), 0)... };
+			(void)expand;
+		}
+
+		// PlayerInfo has no default constructor
+		void players(std::vector<sc2::PlayerInfo> & players)
+		{
+			uint32_t size = static_cast<uint32_t>(players.size());
+			(*this)(size);
+			for (auto & player : players)
+			{
+				fields(player.player_id, player.player_type, player.race_requested, player.race_actual, player.difficulty);
+			}
+		}
+
+		// run length encoded, the grids change in few places from step to step
+		void grid(std::string & grid)
+		{
+			uint32_t size = static_cast<uint32_t>(grid.size());
+			(*this)(size);
+			for (size_t i = 0; i < grid.size();)
+			{
+				char value = grid[i];
+				uint16_t run = 1;
+				while (i + run < grid.size() && grid[i + run] == value && run < UINT16_MAX)
+				{
+					++run;
+				}
+				fields(value, run);
+				i += run;
+			}
+		}
+	};
+
+	class Decoder
+	{
+		const char *	m_next;
+		const char *	m_end;
+
+		bool take(void * value, size_t size)
+		{
+			if (failed || static_cast<size_t>(m_end - m_next) < size)
+			{
+				failed = true;
+				return false;
+			}
+			std::memcpy(value, m_next, size);
+			m_next += size;
+			return true;
+		}
+
+		// every element takes at least a byte, so a broken size fails here instead of allocating
+		bool takeSize(uint32_t & size)
+		{
+			if (!take(&size, sizeof(size)) || size > static_cast<size_t>(m_end - m_next))
+			{
+				failed = true;
+				size = 0;
+				return false;
+			}
+			return true;
+		}
+
+	public:
+
+		bool	failed;
+
+		Decoder(const std::string & data)
+			: m_next(data.data())
+			, m_end(data.data() + data.size())
+			, failed(false)
+		{
+
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_trivially_copyable<T>::value>::type operator()(T & value)
+		{
+			take(&value, sizeof(T));
+		}
+
+		template <typename T>
+		typename std::enable_if<!std::is_trivially_copyable<T>::value>::type operator()(T & value)
+		{
+			serialize(*this, value);
+		}
+
+		void operator()(std::string & value)
+		{
+			uint32_t size = 0;
+			if (takeSize(size))
+			{
+				value.assign(m_next, size);
+				m_next += size;
+			}
+		}
+
+		template <typename T>
+		void operator()(std::vector<T> & values)
+		{
+			uint32_t size = 0;
+			takeSize(size);
+			values.clear();
+			values.resize(size);
+			for (auto & value : values)
+			{
+				(*this)(value);
+			}
+		}
+
+		template <typename K, typename V>
+		void operator()(std::map<K, V> & values)
+		{
+			uint32_t size = 0;
+			takeSize(size);
+			values.clear();
+			for (uint32_t i = 0; i < size && !failed; ++i)
+			{
+				K key;
+				V value;
+				(*this)(key);
+				(*this)(value);
+				values[key] = value;
+			}
+		}
+
+		template <typename... T>
+		void fields(T &... values)
+		{
+			const int expand[] = { 0, ((*this)(values), 0)... };
+			(void)expand;
+		}
+
+		void players(std::vector<sc2::PlayerInfo> & players)
+		{
+			uint32_t size = 0;
+			takeSize(size);
+			players.clear();
+			for (uint32_t i = 0; i < size && !failed; ++i)
+			{
+				uint32_t id = 0;
+				sc2::PlayerType type = sc2::PlayerType::Participant;
+				sc2::Race requested = sc2::Race::Random;
+				sc2::Race actual = sc2::Race::Random;
+				sc2::Difficulty difficulty = sc2::Difficulty::VeryEasy;
+				fields(id, type, requested, actual, difficulty);
+				players.push_back(sc2::PlayerInfo(id, type, requested, actual, difficulty));
+			}
+		}
+
+		void grid(std::string & grid)
+		{
+			uint32_t size = 0;
+			take(&size, sizeof(size));
+			grid.clear();
+			while (grid.size() < size && !failed)
+			{
+				char value = 0;
+				uint16_t run = 0;
+				fields(value, run);
+				if (run == 0 || grid.size() + run > size)
+				{
+					failed = true;
+					break;
+				}
+				grid.append(run, value);
+			}
+		}
+	};
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::Unit & unit)
+	{
+		ar.fields(unit.display_type, unit.alliance, unit.tag, unit.unit_type, unit.owner, unit.pos, unit.facing, unit.radius, unit.build_progress,
+			unit.cloak, unit.detect_range, unit.radar_range, unit.is_selected, unit.is_on_screen, unit.is_blip, unit.health, unit.health_max,
+			unit.shield, unit.shield_max, unit.energy, unit.energy_max, unit.mineral_contents, unit.vespene_contents, unit.is_flying,
+			unit.is_burrowed, unit.weapon_cooldown, unit.orders, unit.add_on_tag, unit.passengers, unit.cargo_space_taken, unit.cargo_space_max,
+			unit.assigned_harvesters, unit.ideal_harvesters, unit.engaged_target_tag, unit.buffs, unit.is_powered, unit.is_alive, unit.last_seen_game_loop);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::Weapon & weapon)
+	{
+		ar.fields(weapon.type, weapon.damage_, weapon.damage_bonus, weapon.attacks, weapon.range, weapon.speed);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::UnitTypeData & data)
+	{
+		ar.fields(data.unit_type_id, data.name, data.available, data.cargo_size, data.mineral_cost, data.vespene_cost, data.attributes,
+			data.movement_speed, data.armor, data.weapons, data.food_required, data.food_provided, data.ability_id, data.race, data.build_time,
+			data.has_vespene, data.has_minerals, data.sight_range, data.tech_alias, data.unit_alias, data.tech_requirement, data.require_attached);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::AbilityData & data)
+	{
+		ar.fields(data.available, data.ability_id, data.link_name, data.link_index, data.button_name, data.friendly_name, data.hotkey,
+			data.remaps_to_ability_id, data.remaps_from_ability_id, data.target, data.allow_minimap, data.allow_autocast, data.is_building,
+			data.footprint_radius, data.is_instant_placement, data.cast_range);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::UpgradeData & data)
+	{
+		ar.fields(data.upgrade_id, data.name, data.mineral_cost, data.vespene_cost, data.ability_id, data.research_time);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::BuffData & data)
+	{
+		ar.fields(data.buff_id, data.name);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::EffectData & data)
+	{
+		ar.fields(data.effect_id, data.name, data.friendly_name, data.radius);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::Effect & effect)
+	{
+		ar.fields(effect.effect_id, effect.positions);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::AvailableAbilities & abilities)
+	{
+		ar.fields(abilities.abilities, abilities.unit_tag, abilities.unit_type_id);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::ImageData & image)
+	{
+		ar.fields(image.width, image.height, image.bits_per_pixel, image.data);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, sc2::GameInfo & info)
+	{
+		ar.fields(info.width, info.height, info.pathing_grid, info.terrain_height, info.placement_grid, info.playable_min, info.playable_max,
+			info.enemy_start_locations, info.start_locations, info.map_name, info.local_map_path);
+		ar.players(info.player_info);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, RecordedEvent & event)
+	{
+		ar.fields(event.type, event.unit);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, RecordedAction & action)
+	{
+		ar.fields(action.target, action.units, action.ability, action.point, action.targetTag, action.queued);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, RecordedStep & step)
+	{
+		ar.fields(step.gameLoop, step.minerals, step.vespene, step.foodCap, step.foodUsed, step.foodWorkers, step.camera, step.events, step.units);
+		ar.grid(step.visibility);
+		ar.grid(step.creep);
+		ar.fields(step.effects, step.upgrades, step.powerSources, step.pathing, step.placement, step.abilities, step.tasks, step.ranAhead,
+			step.aheadTasks, step.actions);
+	}
+
+	template <typename Archive>
+	void serialize(Archive & ar, RecordedGame & game)
+	{
+		ar.fields(game.playerID, game.startLocation, game.gameInfo, game.unitTypes, game.abilities, game.upgrades, game.buffs, game.effects, game.start);
+	}
+
+	bool samePoint(const sc2::Point2D & a, const sc2::Point2D & b)
+	{
+		return a.x == b.x && a.y == b.y;
+	}
+
+	bool lessPoint(const sc2::Point2D & a, const sc2::Point2D & b)
+	{
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	}
+}
+
+bool RecordedAction::operator==(const RecordedAction & other) const
+{
+	return target == other.target && units == other.units && ability == other.ability && samePoint(point, other.point)
+		&& targetTag == other.targetTag && queued == other.queued;
+}
+
+bool RecordedAction::operator!=(const RecordedAction & other) const
+{
+	return !(*this == other);
+}
+
+bool PathingKey::operator<(const PathingKey & other) const
+{
+	if (unit != other.unit)
+	{
+		return unit < other.unit;
+	}
+	if (!samePoint(start, other.start))
+	{
+		return lessPoint(start, other.start);
+	}
+	return lessPoint(end, other.end);
+}
+
+bool PlacementKey::operator<(const PlacementKey & other) const
+{
+	if (ability != other.ability)
+	{
+		return static_cast<uint32_t>(ability) < static_cast<uint32_t>(other.ability);
+	}
+	if (!samePoint(position, other.position))
+	{
+		return lessPoint(position, other.position);
+	}
+	return unit < other.unit;
+}
+
+sc2::Point2D getAddonPosition(const sc2::Point2D & position)
+{
+	// the building covers the 3x3 around position, the addon the 2x2 right of it aligned with its bottom
+	return sc2::Point2D(position.x + 3.0f, position.y);
+}
+
+RecordedStep::RecordedStep()
+	: gameLoop(0)
+	, minerals(0)
+	, vespene(0)
+	, foodCap(0)
+	, foodUsed(0)
+	, foodWorkers(0)
+	, ranAhead(false)
+{
+
+}
+
+bool RecordFileWriter::open(const std::string & fileName)
+{
+	m_file.open(fileName, std::ios::binary | std::ios::trunc);
+	return m_file.is_open();
+}
+
+bool RecordFileWriter::isOpen() const
+{
+	return m_file.is_open();
+}
+
+void RecordFileWriter::writeRecord(RecordKind kind, const std::string & payload)
+{
+	const uint32_t size = static_cast<uint32_t>(payload.size());
+	m_file.write(reinterpret_cast<const char *>(&kind), sizeof(kind));
+	m_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	m_file.write(payload.data(), payload.size());
+}
+
+void RecordFileWriter::write(const RecordedGame & game)
+{
+	Encoder encoder;
+	encoder(const_cast<RecordedGame &>(game));
+	writeRecord(RecordKind::Game, encoder.data);
+}
+
+void RecordFileWriter::write(const RecordedStep & step)
+{
+	Encoder encoder;
+	encoder(const_cast<RecordedStep &>(step));
+	writeRecord(RecordKind::Step, encoder.data);
+}
+
+void RecordFileWriter::close()
+{
+	m_file.close();
+}
+
+bool RecordFileReader::open(const std::string & fileName)
+{
+	m_file.open(fileName, std::ios::binary);
+	return m_file.is_open();
+}
+
+bool RecordFileReader::readRecord(RecordKind kind, std::string & payload)
+{
+	RecordKind readKind;
+	uint32_t size = 0;
+	if (!m_file.read(reinterpret_cast<char *>(&readKind), sizeof(readKind)) || !m_file.read(reinterpret_cast<char *>(&size), sizeof(size)) || readKind != kind)
+	{
+		return false;
+	}
+	payload.resize(size);
+	return static_cast<bool>(m_file.read(&payload[0], size));
+}
+
+bool RecordFileReader::read(RecordedGame & game)
+{
+	std::string payload;
+	if (!readRecord(RecordKind::Game, payload))
+	{
+		return false;
+	}
+	Decoder decoder(payload);
+	decoder(game);
+	return !decoder.failed;
+}
+
+bool RecordFileReader::read(RecordedStep & step)
+{
+	std::string payload;
+	if (!readRecord(RecordKind::Step, payload))
+	{
+		return false;
+	}
+	Decoder decoder(payload);
+	decoder(step);
+	return !decoder.failed;
+}
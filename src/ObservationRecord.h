@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Common.h"
+#include <fstream>
+#include <map>
+
+// what the bot saw and did, written by the ObservationRecorder and replayed by the bench.
+// A record file is a sequence of records: a kind byte, the payload length as uint32 and the payload.
+// The first record is the game, each further one a step. Numbers are written as they are in memory,
+// so a file is read back by a build for the same platform.
+
+enum class RecordKind : uint8_t { Game = 1, Step = 2 };
+enum class RecordedEventType : uint8_t { Created, Destroyed, Idle, ConstructionComplete, EnterVision };
+
+struct RecordedEvent
+{
+	RecordedEventType	type;
+	sc2::Unit			unit;		// as the event saw it
+};
+
+// one call of ActionInterface::UnitCommand
+struct RecordedAction
+{
+	enum class Target : uint8_t { None, Point, Unit };
+
+	Target					target;
+	std::vector<sc2::Tag>	units;
+	sc2::AbilityID			ability;
+	sc2::Point2D			point;
+	sc2::Tag				targetTag;
+	bool					queued;
+
+	bool operator==(const RecordedAction & other) const;
+	bool operator!=(const RecordedAction & other) const;
+};
+
+struct PathingKey
+{
+	sc2::Tag		unit;		// NullTag if it starts at start
+	sc2::Point2D	start;
+	sc2::Point2D	end;
+
+	bool operator<(const PathingKey & other) const;
+};
+
+struct PlacementKey
+{
+	sc2::AbilityID	ability;
+	sc2::Point2D	position;
+	sc2::Tag		unit;
+
+	bool operator<(const PlacementKey & other) const;
+};
+
+// where the bot asks to place the 2x2 of the addon of a building it asked to place at position
+sc2::Point2D	getAddonPosition(const sc2::Point2D & position);
+
+// the observation of one step and everything the bot asked and did in it. Queries are kept by what was asked,
+// so they replay the same when jobs on the thread pool ask in another order.
+struct RecordedStep
+{
+	uint32_t	gameLoop;
+	int32_t		minerals;
+	int32_t		vespene;
+	int32_t		foodCap;
+	int32_t		foodUsed;
+	int32_t		foodWorkers;
+	sc2::Point2D	camera;
+	std::vector<RecordedEvent>		events;			// the events before the step
+	std::vector<sc2::Unit>			units;
+	std::string						visibility;		// a sc2::Visibility per tile, x + y * width
+	std::string						creep;			// 1 for creep, x + y * width
+	std::vector<sc2::Effect>		effects;
+	std::vector<sc2::UpgradeID>		upgrades;
+	std::vector<sc2::PowerSource>	powerSources;
+	std::map<PathingKey, float>		pathing;
+	std::map<PlacementKey, bool>	placement;
+	std::map<sc2::Tag, sc2::AvailableAbilities>	abilities;
+	std::vector<uint32_t>			tasks;			// the scheduler tasks that ran, see TaskScheduler::getLastRun
+	bool							ranAhead;
+	std::vector<uint32_t>			aheadTasks;
+	std::vector<RecordedAction>		actions;		// sent at the end of the step
+
+	RecordedStep();
+};
+
+struct RecordedGame
+{
+	uint32_t		playerID;
+	sc2::Point3D	startLocation;
+	sc2::GameInfo	gameInfo;
+	sc2::UnitTypes	unitTypes;
+	sc2::Abilities	abilities;
+	sc2::Upgrades	upgrades;
+	sc2::Buffs		buffs;
+	sc2::Effects	effects;
+	RecordedStep	start;			// what OnGameStart saw and asked
+};
+
+class RecordFileWriter
+{
+	std::ofstream	m_file;
+
+	void	writeRecord(RecordKind kind, const std::string & payload);
+
+public:
+
+	bool	open(const std::string & fileName);
+	bool	isOpen() const;
+	void	write(const RecordedGame & game);
+	void	write(const RecordedStep & step);
+	void	close();
+};
+
+class RecordFileReader
+{
+	std::ifstream	m_file;
+
+	bool	readRecord(RecordKind kind, std::string & payload);
+
+public:
+
+	bool	open(const std::string & fileName);
+	bool	read(RecordedGame & game);
+	// false at the end of the file
+	bool	read(RecordedStep & step);
+};
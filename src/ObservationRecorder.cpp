@@ -0,0 +1,338 @@
+#include "ObservationRecorder.h"
+#include "CCBot.h"
+
+ObservationRecorder::ObservationRecorder(CCBot & bot)
+	: m_bot(bot)
+	, m_query(nullptr)
+	, m_actions(nullptr)
+	, m_gameWritten(false)
+	, m_random(1)
+{
+
+}
+
+bool ObservationRecorder::start(const std::string & fileName, sc2::QueryInterface * query, sc2::ActionInterface * actions)
+{
+	if (!m_file.open(fileName))
+	{
+		std::cout << "Unable to record the observations to " << fileName << std::endl;
+		return false;
+	}
+	m_query = query;
+	m_actions = actions;
+
+	const sc2::ObservationInterface * observation = m_bot.Observation();
+	m_game.playerID = observation->GetPlayerID();
+	m_game.startLocation = observation->GetStartLocation();
+	m_game.gameInfo = observation->GetGameInfo();
+	m_game.unitTypes = observation->GetUnitTypeData();
+	m_game.abilities = observation->GetAbilityData();
+	m_game.upgrades = observation->GetUpgradeData();
+	m_game.buffs = observation->GetBuffData();
+	m_game.effects = observation->GetEffectData();
+	m_gameWritten = false;
+	m_step = RecordedStep();
+	observe(m_step);
+	return true;
+}
+
+bool ObservationRecorder::isRecording() const
+{
+	return m_file.isOpen();
+}
+
+void ObservationRecorder::observe(RecordedStep & step) const
+{
+	const sc2::ObservationInterface * observation = m_bot.Observation();
+	step.gameLoop = observation->GetGameLoop();
+	step.minerals = observation->GetMinerals();
+	step.vespene = observation->GetVespene();
+	step.foodCap = observation->GetFoodCap();
+	step.foodUsed = observation->GetFoodUsed();
+	step.foodWorkers = observation->GetFoodWorkers();
+	step.camera = observation->GetCameraPos();
+	for (const auto unit : observation->GetUnits())
+	{
+		step.units.push_back(*unit);
+	}
+
+	const int width = m_game.gameInfo.width;
+	const int height = m_game.gameInfo.height;
+	step.visibility.resize(width * height);
+	step.creep.resize(width * height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const sc2::Point2D tile(x + 0.5f, y + 0.5f);
+			step.visibility[x + y * width] = static_cast<char>(observation->GetVisibility(tile));
+			step.creep[x + y * width] = observation->HasCreep(tile) ? 1 : 0;
+		}
+	}
+	step.effects = observation->GetEffects();
+	step.upgrades = observation->GetUpgrades();
+	step.powerSources = observation->GetPowerSources();
+}
+
+void ObservationRecorder::onEvent(RecordedEventType type, const sc2::Unit * unit)
+{
+	if (!isRecording() || !unit)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_events.push_back({ type, *unit });
+}
+
+// closes the last step, the game record waits for the answers OnGameStart got
+void ObservationRecorder::onStep()
+{
+	if (!isRecording())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_gameWritten)
+		{
+			m_file.write(m_step);
+		}
+		else
+		{
+			m_game.start = m_step;
+			m_file.write(m_game);
+			m_gameWritten = true;
+		}
+		m_step = RecordedStep();
+		m_step.events.swap(m_events);
+		observe(m_step);
+	}
+	samplePlacements();
+}
+
+// the bot only asks the game about spots its local placement rules accept. So the bench can also find the spots
+// they reject wrongly, we ask about a few random ones around the bases every step.
+void ObservationRecorder::samplePlacements()
+{
+	const std::vector<const BaseLocation *> & bases = m_bot.Bases().getBaseLocations();
+	if (bases.empty())
+	{
+		return;
+	}
+	std::uniform_int_distribution<size_t> base(0, bases.size() - 1);
+	std::uniform_int_distribution<int> offset(-12, 12);
+	std::vector<sc2::QueryInterface::PlacementQuery> queries;
+	for (const sc2::AbilityID ability : { sc2::ABILITY_ID::BUILD_SUPPLYDEPOT, sc2::ABILITY_ID::BUILD_BARRACKS, sc2::ABILITY_ID::BUILD_COMMANDCENTER })
+	{
+		const sc2::Point2D & depot = bases[base(m_random)]->getDepotPosition();
+		const float x = std::floor(depot.x) + offset(m_random);
+		const float y = std::floor(depot.y) + offset(m_random);
+		queries.push_back(sc2::QueryInterface::PlacementQuery(ability, sc2::Point2D(x, y)));
+	}
+	Placement(queries);
+}
+
+void ObservationRecorder::onTasks(const std::vector<uint32_t> & tasks, bool ahead)
+{
+	if (!isRecording())
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (ahead)
+	{
+		m_step.ranAhead = true;
+		m_step.aheadTasks = tasks;
+	}
+	else
+	{
+		m_step.tasks = tasks;
+	}
+}
+
+void ObservationRecorder::stop()
+{
+	if (!isRecording())
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_gameWritten)
+	{
+		m_file.write(m_step);
+	}
+	else
+	{
+		m_game.start = m_step;
+		m_file.write(m_game);
+	}
+	m_file.close();
+}
+
+sc2::AvailableAbilities ObservationRecorder::GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements)
+{
+	const sc2::AvailableAbilities abilities = m_query->GetAbilitiesForUnit(unit, ignore_resource_requirements);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.abilities[unit->tag] = abilities;
+	return abilities;
+}
+
+std::vector<sc2::AvailableAbilities> ObservationRecorder::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	const std::vector<sc2::AvailableAbilities> abilities = m_query->GetAbilitiesForUnits(units, ignore_resource_requirements);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const auto & unitAbilities : abilities)
+	{
+		m_step.abilities[unitAbilities.unit_tag] = unitAbilities;
+	}
+	return abilities;
+}
+
+float ObservationRecorder::PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end)
+{
+	const float distance = m_query->PathingDistance(start, end);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.pathing[{ sc2::NullTag, start, end }] = distance;
+	return distance;
+}
+
+float ObservationRecorder::PathingDistance(const sc2::Unit * start, const sc2::Point2D & end)
+{
+	const float distance = m_query->PathingDistance(start, end);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.pathing[{ start->tag, sc2::Point2D(), end }] = distance;
+	return distance;
+}
+
+std::vector<float> ObservationRecorder::PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries)
+{
+	const std::vector<float> distances = m_query->PathingDistance(queries);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < queries.size() && i < distances.size(); ++i)
+	{
+		m_step.pathing[{ queries[i].start_unit_tag_, queries[i].start_, queries[i].end_ }] = distances[i];
+	}
+	return distances;
+}
+
+bool ObservationRecorder::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit)
+{
+	const bool placeable = m_query->Placement(ability, target_pos, unit);
+	recordAddonPlacement(ability, target_pos);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.placement[{ ability, target_pos, unit ? unit->tag : sc2::NullTag }] = placeable;
+	return placeable;
+}
+
+std::vector<bool> ObservationRecorder::Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries)
+{
+	const std::vector<bool> placeable = m_query->Placement(queries);
+	for (const auto & query : queries)
+	{
+		recordAddonPlacement(query.ability, query.target_pos);
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < queries.size() && i < placeable.size(); ++i)
+	{
+		m_step.placement[{ queries[i].ability, queries[i].target_pos, queries[i].placing_unit_tag }] = placeable[i];
+	}
+	return placeable;
+}
+
+// the game does not check the space for the addon when placing the building. The bench compares the local
+// placement rules with the record, so we also ask for the 2x2 of the addon, as a depot right of the building.
+void ObservationRecorder::recordAddonPlacement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos)
+{
+	if (ability != sc2::ABILITY_ID::BUILD_BARRACKS && ability != sc2::ABILITY_ID::BUILD_FACTORY && ability != sc2::ABILITY_ID::BUILD_STARPORT)
+	{
+		return;
+	}
+	const PlacementKey addon{ sc2::ABILITY_ID::BUILD_SUPPLYDEPOT, getAddonPosition(target_pos), sc2::NullTag };
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_step.placement.count(addon) > 0)
+		{
+			return;
+		}
+	}
+	const bool placeable = m_query->Placement(addon.ability, addon.position);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.placement[addon] = placeable;
+}
+
+void ObservationRecorder::addAction(RecordedAction::Target target, const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * targetUnit, bool queued)
+{
+	RecordedAction action;
+	action.target = target;
+	for (const auto unit : units)
+	{
+		action.units.push_back(unit->tag);
+	}
+	action.ability = ability;
+	action.point = point;
+	action.targetTag = targetUnit ? targetUnit->tag : sc2::NullTag;
+	action.queued = queued;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_step.actions.push_back(action);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command)
+{
+	addAction(RecordedAction::Target::None, { unit }, ability, sc2::Point2D(), nullptr, queued_command);
+	m_actions->UnitCommand(unit, ability, queued_command);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	addAction(RecordedAction::Target::Point, { unit }, ability, point, nullptr, queued_command);
+	m_actions->UnitCommand(unit, ability, point, queued_command);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	addAction(RecordedAction::Target::Unit, { unit }, ability, sc2::Point2D(), target, queued_command);
+	m_actions->UnitCommand(unit, ability, target, queued_command);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move)
+{
+	addAction(RecordedAction::Target::None, units, ability, sc2::Point2D(), nullptr, queued_move);
+	m_actions->UnitCommand(units, ability, queued_move);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	addAction(RecordedAction::Target::Point, units, ability, point, nullptr, queued_command);
+	m_actions->UnitCommand(units, ability, point, queued_command);
+}
+
+void ObservationRecorder::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	addAction(RecordedAction::Target::Unit, units, ability, sc2::Point2D(), target, queued_command);
+	m_actions->UnitCommand(units, ability, target, queued_command);
+}
+
+const std::vector<sc2::Tag> & ObservationRecorder::Commands() const
+{
+	return m_actions->Commands();
+}
+
+void ObservationRecorder::ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability)
+{
+	m_actions->ToggleAutocast(unit_tag, ability);
+}
+
+void ObservationRecorder::ToggleAutocast(const std::vector<sc2::Tag> & unit_tags, sc2::AbilityID ability)
+{
+	m_actions->ToggleAutocast(unit_tags, ability);
+}
+
+void ObservationRecorder::SendChat(const std::string & message, sc2::ChatChannel channel)
+{
+	m_actions->SendChat(message, channel);
+}
+
+void ObservationRecorder::SendActions()
+{
+	m_actions->SendActions();
+}
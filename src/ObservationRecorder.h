@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+#include "ObservationRecord.h"
+#include <mutex>
+#include <random>
+
+class CCBot;
+
+// writes every step of the game to a record file when RecordObservations is set, the bench replays it.
+// While recording it stands in for the query and action interfaces, keeps the answers and commands of the step
+// and passes everything on to the game.
+class ObservationRecorder : public sc2::QueryInterface, public sc2::ActionInterface
+{
+	CCBot &						m_bot;
+	sc2::QueryInterface *		m_query;
+	sc2::ActionInterface *		m_actions;
+	RecordFileWriter			m_file;
+	RecordedGame				m_game;
+	bool						m_gameWritten;
+	RecordedStep				m_step;
+	std::vector<RecordedEvent>	m_events;
+	std::mutex					m_mutex;
+	std::mt19937				m_random;
+
+	void	observe(RecordedStep & step) const;
+	void	addAction(RecordedAction::Target target, const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * targetUnit, bool queued);
+	void	recordAddonPlacement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos);
+	void	samplePlacements();
+
+public:
+
+	ObservationRecorder(CCBot & bot);
+
+	// takes the game data, call it first thing in OnGameStart
+	bool	start(const std::string & fileName, sc2::QueryInterface * query, sc2::ActionInterface * actions);
+	bool	isRecording() const;
+	void	onEvent(RecordedEventType type, const sc2::Unit * unit);
+	// after the observation of the step arrived
+	void	onStep();
+	void	onTasks(const std::vector<uint32_t> & tasks, bool ahead);
+	void	stop();
+
+	// QueryInterface
+	sc2::AvailableAbilities	GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities>	GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	float		PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end) override;
+	float		PathingDistance(const sc2::Unit * start, const sc2::Point2D & end) override;
+	std::vector<float>	PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries) override;
+	bool		Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+	std::vector<bool>	Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries) override;
+
+	// ActionInterface
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	const std::vector<sc2::Tag> &	Commands() const override;
+	void	ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) override;
+	void	ToggleAutocast(const std::vector<sc2::Tag> & unit_tags, sc2::AbilityID ability) override;
+	void	SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) override;
+	void	SendActions() override;
+};
@@ -0,0 +1,98 @@
+#include "PathingQueryBatcher.h"
+#include "CCBot.h"
+#include "Util.h"
+
+PathingQueryBatcher::PathingQueryBatcher(CCBot & bot)
+	: m_bot(bot)
+	, m_deferred(false)
+{
+
+}
+
+void PathingQueryBatcher::onFrame()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	const UnitDeltas & deltas = m_bot.UnitInfo().getUnitDeltas();
+	// only buildings that were built, died or changed their footprint change the paths. Enemy buildings
+	// entering or leaving vision were there before and after
+	bool changed = false;
+	for (const sc2::Units * units : { &deltas.created, &deltas.destroyed, &deltas.morphed })
+	{
+		for (const auto & unit : *units)
+		{
+			changed = changed || Util::IsBuildingType(unit->unit_type, m_bot);
+		}
+	}
+	if (changed)
+	{
+		m_distances.clear();
+	}
+	if (m_deferred)
+	{
+		m_deferred = false;
+		resolvePending();
+	}
+}
+
+uint64_t PathingQueryBatcher::getKey(const sc2::Point2D & from, const sc2::Point2D & to) const
+{
+	return (static_cast<uint64_t>(from.x) << 48) | (static_cast<uint64_t>(from.y) << 32) | (static_cast<uint64_t>(to.x) << 16) | static_cast<uint64_t>(to.y);
+}
+
+void PathingQueryBatcher::request(const sc2::Point2D & from, const sc2::Point2D & to)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	const uint64_t key = getKey(from, to);
+	if (m_distances.find(key) != m_distances.end() || !m_pendingKeys.insert(key).second)
+	{
+		return;
+	}
+	sc2::QueryInterface::PathingQuery query;
+	query.start_ = from;
+	query.end_ = to;
+	m_pending.push_back(query);
+}
+
+void PathingQueryBatcher::resolvePending()
+{
+	if (m_pending.empty())
+	{
+		return;
+	}
+	std::vector<float> distances;
+	{
+		ProfileScope query(m_bot.Profiler(), "Query PathingDistance", "api");
+		distances = m_bot.Query()->PathingDistance(m_pending);
+	}
+	for (size_t i = 0; i < m_pending.size(); ++i)
+	{
+		// the engine answers 0 if there is no path
+		const float distance = i < distances.size() && distances[i] > 0.0f ? distances[i] : -1.0f;
+		m_distances[getKey(m_pending[i].start_, m_pending[i].end_)] = distance;
+	}
+	m_pending.clear();
+	m_pendingKeys.clear();
+}
+
+float PathingQueryBatcher::getDistance(const sc2::Point2D & from, const sc2::Point2D & to)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+	if (static_cast<int>(from.x) == static_cast<int>(to.x) && static_cast<int>(from.y) == static_cast<int>(to.y))
+	{
+		return 0.0f;
+	}
+	const uint64_t key = getKey(from, to);
+	auto it = m_distances.find(key);
+	if (it == m_distances.end())
+	{
+		request(from, to);
+		if (m_bot.Scheduler().isRunningAhead())
+		{
+			m_deferred = true;
+			return -1.0f;
+		}
+		resolvePending();
+		it = m_distances.find(key);
+	}
+	return it->second;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+
+class CCBot;
+
+// true pathing distances of the engine. All pairs requested during a frame are resolved with one query,
+// the results are kept per tile pair until a structure appears, dies or changes its footprint.
+// Pairs asked about by tasks running ahead are resolved in the next onFrame.
+class PathingQueryBatcher
+{
+	CCBot &		m_bot;
+	std::unordered_map<uint64_t, float>	m_distances;
+	std::vector<sc2::QueryInterface::PathingQuery> m_pending;
+	std::set<uint64_t>	m_pendingKeys;
+	bool		m_deferred;		// a task running ahead left pairs in m_pending
+	// squads ask from several threads
+	std::recursive_mutex m_mutex;
+
+	uint64_t	getKey(const sc2::Point2D & from, const sc2::Point2D & to) const;
+	void		resolvePending();
+
+public:
+
+	PathingQueryBatcher(CCBot & bot);
+
+	void		onFrame();
+
+	// announce a pair we are going to ask about, so it is part of the next batch
+	void		request(const sc2::Point2D & from, const sc2::Point2D & to);
+
+	// -1 if there is no path, or while running ahead if the engine was not asked yet
+	float		getDistance(const sc2::Point2D & from, const sc2::Point2D & to);
+};
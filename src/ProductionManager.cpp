@@ -8,9 +8,8 @@
 const int UNIT = 5;
 const int BUILDING = 3;
 
-//it seems to many commands confuse the engine
-int defaultMacroSleep = 0;
-const int defaultMacroSleepMax = 5;
+//it seems to many commands confuse the engine. In game loops
+const uint32_t defaultMacroSleepLoops = 5;
 bool canBuildAddon = true;
 int addonCounter = 0;
 const int maxAddonCounter = 5;
@@ -20,11 +19,10 @@ bool startedResearch = false;
 ProductionManager::ProductionManager(CCBot & bot)
 	: m_bot(bot)
 	, m_buildingManager(bot)
-	, m_weapons(0)
-	, m_armor(0)
 	, m_scoutRequested(false)
 	, m_vikingRequested(false)
 	, m_scansRequested(0)
+	, m_defaultMacroNextLoop(0)
 {
 
 }
@@ -34,6 +32,11 @@ void ProductionManager::onStart()
 	m_buildingManager.onStart();
 }
 
+void ProductionManager::onUnitDeltas(const UnitDeltas & deltas)
+{
+	m_buildingManager.onUnitDeltas(deltas);
+}
+
 void ProductionManager::onFrame()
 {
 
@@ -89,7 +92,7 @@ void ProductionManager::create(BuildOrderItem item)
 	//We want to switch addons from factory to starport. So better build them close.
 	else if (item.type.getUnitTypeID().ToType() == sc2::UNIT_TYPEID::TERRAN_STARPORT)
 	{
-		const sc2::Units Factories = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_FACTORY , sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING }));
+		const UnitSpan Factories = m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_FACTORY);
 		if (Factories.size() > 0)
 		{
 			m_buildingManager.addBuildingTask(item.type.getUnitTypeID(), Factories[0]->pos);
@@ -179,12 +182,12 @@ void ProductionManager::defaultMacro()
 {
 
 	//This avoids repeating the same command twice.
-	++defaultMacroSleep;
-	if (defaultMacroSleep < defaultMacroSleepMax)
+	const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+	if (gameLoop < m_defaultMacroNextLoop)
 	{
 		return;
 	}
-	defaultMacroSleep = 0;
+	m_defaultMacroNextLoop = gameLoop + defaultMacroSleepLoops;
 
 	//It seems that for now player 2 can not build addons. Since we do not know which one we are, we first try a few times
 	if (canBuildAddon && addonCounter > maxAddonCounter)
@@ -194,7 +197,7 @@ void ProductionManager::defaultMacro()
 	}
 
 	//Even without money we can drop mules
-	const sc2::Units CommandCenters = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER , sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND , sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS }));
+	const UnitSpan CommandCenters = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::TownHall);
 	int scansAvailable = 0;
 	for (const auto & unit : CommandCenters)
 	{
@@ -209,6 +212,7 @@ void ProductionManager::defaultMacro()
 					if (mineralPatch && mineralPatch->Visible == sc2::Unit::DisplayType::Visible)
 					{
 						m_bot.Actions()->UnitCommand(unit, sc2::ABILITY_ID::EFFECT_CALLDOWNMULE, mineralPatch);
+						m_bot.Abilities().onCast(unit, sc2::ABILITY_ID::EFFECT_CALLDOWNMULE);
 					}
 				}
 			}
@@ -225,7 +229,7 @@ void ProductionManager::defaultMacro()
 	//but not much else
 	if (minerals < 50)
 	{
-		defaultMacroSleep = defaultMacroSleepMax;
+		m_defaultMacroNextLoop = 0;
 		return;
 	}
 	int32_t gas = getFreeGas();
@@ -235,26 +239,26 @@ void ProductionManager::defaultMacro()
 	
 
 	//Maybe it would be smarter to search for all buildings first and then search through the resulting vector
-	const sc2::Units Depots = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT , sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED }));
+	const UnitSpan Depots = m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT);
 	const int numDepots = static_cast<int>(Depots.size());
 	const int numDepotsFinished = buildingsFinished(Depots);
 
 	const int numBases = static_cast<int>(CommandCenters.size());
 	const int numBasesFinished = buildingsFinished(CommandCenters);
 
-	const sc2::Units Rax = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit( sc2::UNIT_TYPEID::TERRAN_BARRACKS));
+	const UnitSpan Rax = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_BARRACKS);
 	const int numRax = static_cast<int>(Rax.size());
 	const int numRaxFinished = buildingsFinished(Rax);
 
-	const sc2::Units Starports = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_STARPORT , sc2::UNIT_TYPEID::TERRAN_STARPORTFLYING }));
+	const UnitSpan Starports = m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_STARPORT);
 	const int numStarport = static_cast<int>(Starports.size());
 	const int numStarportFinished = buildingsFinished(Starports);
 
-	const sc2::Units Factories = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_FACTORY , sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING }));
+	const UnitSpan Factories = m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_FACTORY);
 	const int numFactory = static_cast<int>(Factories.size());
 	const int numFactoryFinished = buildingsFinished(Factories);
 
-	const sc2::Units Engibays = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit( sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY));
+	const UnitSpan Engibays = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY);
 	const int numEngibays = static_cast<int>(Engibays.size());
 	const int numEngibaysFinished = buildingsFinished(Engibays);
 
@@ -310,13 +314,12 @@ void ProductionManager::defaultMacro()
 		}
 	}
 	//Upgrades techlab
-	const sc2::Units bTechLab = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB));
-	std::vector<sc2::UpgradeID> upgrades = m_bot.Observation()->GetUpgrades();
+	const UnitSpan bTechLab = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
 	for (const auto & unit : bTechLab)
 	{
 		if (unit->build_progress == 1 && unit->orders.empty())
 		{
-			if (std::find(upgrades.begin(),upgrades.end(),sc2::UPGRADE_ID::SHIELDWALL) == upgrades.end())
+			if (!m_bot.UnitInfo().hasUpgrade(sc2::UPGRADE_ID::SHIELDWALL) && !m_bot.UnitInfo().isResearching(sc2::UPGRADE_ID::SHIELDWALL))
 			{
 				//If you have enough minerals but not enough gas do not block. That mins could be marines.
 				if (gas >= 100)
@@ -329,7 +332,7 @@ void ProductionManager::defaultMacro()
 					return;
 				}
 			}
-			else if (std::find(upgrades.begin(), upgrades.end(), sc2::UPGRADE_ID::STIMPACK) == upgrades.end())
+			else if (!m_bot.UnitInfo().hasUpgrade(sc2::UPGRADE_ID::STIMPACK) && !m_bot.UnitInfo().isResearching(sc2::UPGRADE_ID::STIMPACK))
 			{
 				//If you have enough minerals but not enough gas do not block. That mins could be marines.
 				if (gas >= 100)
@@ -342,7 +345,7 @@ void ProductionManager::defaultMacro()
 					return;
 				}
 			}
-			else if (std::find(upgrades.begin(), upgrades.end(), sc2::UPGRADE_ID::PUNISHERGRENADES) == upgrades.end())
+			else if (!m_bot.UnitInfo().hasUpgrade(sc2::UPGRADE_ID::PUNISHERGRENADES) && !m_bot.UnitInfo().isResearching(sc2::UPGRADE_ID::PUNISHERGRENADES))
 			{
 				//If you have enough minerals but not enough gas do not block. That mins could be marines.
 				if (gas >= 50)
@@ -360,9 +363,12 @@ void ProductionManager::defaultMacro()
 	}
 
 	//upgrades
-	const sc2::Units Armories = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_ARMORY));
+	const UnitSpan Armories = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_ARMORY);
 	const int numArmories = static_cast<int>(Armories.size());
 	const int numArmoriesFinished = buildingsFinished(Armories);
+	// levels we already have or are researching
+	const int weapons = m_bot.UnitInfo().getInfantryWeaponLevel(true);
+	const int armor = m_bot.UnitInfo().getInfantryArmorLevel(true);
 	for (const auto & unit : Engibays)
 	{
 		if (unit->build_progress == 1)
@@ -371,9 +377,9 @@ void ProductionManager::defaultMacro()
 			{
 					//If you have enough minerals but not enough gas do not block. That mins could be marines.
 				//Weapons first
-				if ((m_weapons == 0 && m_armor == 0 && gas >= 100) || (m_weapons == 1 && m_armor == 1 && gas >= 175 && numArmoriesFinished>0) || (m_weapons == 2 && m_armor == 2 && gas >= 250))
+				if ((weapons == 0 && armor == 0 && gas >= 100) || (weapons == 1 && armor == 1 && gas >= 175 && numArmoriesFinished>0) || (weapons == 2 && armor == 2 && gas >= 250))
 				{
-					if ((m_weapons == 0 && minerals >= 100) || (m_weapons == 1 && minerals >= 175) || (m_weapons == 2 && minerals >= 250))
+					if ((weapons == 0 && minerals >= 100) || (weapons == 1 && minerals >= 175) || (weapons == 2 && minerals >= 250))
 					{
 						m_bot.Actions()->UnitCommand(unit, sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONS);
 						startedResearch = true;
@@ -381,9 +387,9 @@ void ProductionManager::defaultMacro()
 					std::cout << "Weapon++" << std::endl;
 					return;
 				}
-				if ((m_weapons == 1 && m_armor == 0 && gas >= 100) || (m_weapons == 2 && m_armor == 1 && gas >= 175) || (m_weapons == 3 && m_armor == 2 && gas >= 250))
+				if ((weapons == 1 && armor == 0 && gas >= 100) || (weapons == 2 && armor == 1 && gas >= 175) || (weapons == 3 && armor == 2 && gas >= 250))
 				{
-					if ((m_armor == 0 && minerals >= 100) || (m_armor == 1 && minerals >= 175) || (m_armor == 2 && minerals >= 250))
+					if ((armor == 0 && minerals >= 100) || (armor == 1 && minerals >= 175) || (armor == 2 && minerals >= 250))
 					{
 						m_bot.Actions()->UnitCommand(unit, sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMOR);
 						startedResearch = true;
@@ -394,10 +400,10 @@ void ProductionManager::defaultMacro()
 				
 				/*
 				//THE METHOD BELOW WOULD BE MUCH NICER... BUT THERE IS A BUG :/
-				std::vector<sc2::AvailableAbility> abilities = m_bot.Query()->GetAbilitiesForUnit(unit).abilities;
+				const std::vector<sc2::AvailableAbility> & abilities = m_bot.Abilities().getAbilities(unit);
 				// Weapons and armor research has consecutive numbers
 				//First weapons
-				for (sc2::AvailableAbility & ability : abilities)
+				for (const sc2::AvailableAbility & ability : abilities)
 				{
 					if (ability.ability_id >= sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONSLEVEL1 && ability.ability_id <= sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONSLEVEL3)
 					{
@@ -414,7 +420,7 @@ void ProductionManager::defaultMacro()
 					}
 				}
 				//Then armor
-				for (sc2::AvailableAbility & ability : abilities)
+				for (const sc2::AvailableAbility & ability : abilities)
 				{
 					if (ability.ability_id >= sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL1 && ability.ability_id <= sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL3)
 					{
@@ -435,20 +441,11 @@ void ProductionManager::defaultMacro()
 			else if (startedResearch && !unit->orders.empty())
 			{
 				startedResearch = false;
-				const sc2::AbilityID research = unit->orders.front().ability_id;
-				if (research == sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONS)
-				{
-					m_weapons++;
-				}
-				else if (research == sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMOR)
-				{
-					m_armor++;
-				}
 			}
 		}
 	}
 	//Every rax has to build
-	const sc2::Units bReactor = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_BARRACKSREACTOR));
+	const UnitSpan bReactor = m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_BARRACKSREACTOR);
 	for (const auto & unit : Rax)
 	{
 		//Any finished rax
@@ -572,7 +569,7 @@ void ProductionManager::defaultMacro()
 				}
 				else if (m_bot.Observation()->GetUnit(unit->add_on_tag)->unit_type.ToType() == sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB)
 				{
-					const int numWidowMines = static_cast<int>(m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_WIDOWMINE,sc2::UNIT_TYPEID::TERRAN_WIDOWMINEBURROWED })).size());
+					const int numWidowMines = static_cast<int>(m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_WIDOWMINE).size());
 					if (numWidowMines==0 && minerals >= m_bot.Data(sc2::UNIT_TYPEID::TERRAN_WIDOWMINE).mineralCost && gas >= m_bot.Data(sc2::UNIT_TYPEID::TERRAN_WIDOWMINE).gasCost && supply <= 200 - m_bot.Data(sc2::UNIT_TYPEID::TERRAN_WIDOWMINE).supplyCost)
 					{
 						m_bot.Actions()->UnitCommand(unit, sc2::ABILITY_ID::TRAIN_WIDOWMINE);
@@ -630,8 +627,8 @@ void ProductionManager::defaultMacro()
 					int numMedivacs;
 					if (m_vikingRequested)
 					{
-						numMedivacs = static_cast<int>(m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_MEDIVAC)).size());
-						numVikings = static_cast<int>(m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER,sc2::UNIT_TYPEID::TERRAN_VIKINGASSAULT })).size());
+						numMedivacs = static_cast<int>(m_bot.UnitInfo().getUnits(Players::Self, sc2::UNIT_TYPEID::TERRAN_MEDIVAC).size());
+						numVikings = static_cast<int>(m_bot.UnitInfo().getUnitsWithAliases(Players::Self, sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER).size());
 					}
 					if (!m_vikingRequested || numMedivacs - 2 < numVikings)
 					{
@@ -665,7 +662,7 @@ void ProductionManager::defaultMacro()
 	}
 	if (minerals >= 100 && m_bot.GetPlayerRace(Players::Enemy) != sc2::Race::Terran && numBases == 2)
 	{
-		const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BUNKER }));
+		const UnitSpan Bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 		if (Bunker.size() + howOftenQueued(sc2::UNIT_TYPEID::TERRAN_BUNKER) < 1)
 		{
 			m_newQueue.push_back(BuildOrderItem(BuildType(sc2::UNIT_TYPEID::TERRAN_BUNKER), BUILDING, false));
@@ -683,7 +680,7 @@ void ProductionManager::defaultMacro()
 
 	//Armory
 	//Needed for upgrades after +1
-	if (m_weapons == 1 && m_armor == 1 && gas >= 100 && numArmories + howOftenQueued(sc2::UNIT_TYPEID::TERRAN_ARMORY) == 0)
+	if (weapons == 1 && armor == 1 && gas >= 100 && numArmories + howOftenQueued(sc2::UNIT_TYPEID::TERRAN_ARMORY) == 0)
 	{
 		if (minerals >= 150)
 		{
@@ -770,7 +767,7 @@ void ProductionManager::defaultMacro()
 		return;
 	}
 	//When we did nothing...
-	defaultMacroSleep = defaultMacroSleepMax;
+	m_defaultMacroNextLoop = 0;
 	return;
 }
 
@@ -802,7 +799,7 @@ void ProductionManager::usedScan(int i)
 	}
 }
 
-int ProductionManager::buildingsFinished(sc2::Units units)
+int ProductionManager::buildingsFinished(const UnitSpan & units)
 {
 	int numBuildingsFinished = 0;
 	for (const auto & unit : units)
@@ -4,6 +4,7 @@
 #include "BuildOrder.h"
 #include "BuildingManager.h"
 #include "BuildOrderQueue.h"
+#include "UnitInfoManager.h"
 
 class CCBot;
 
@@ -14,12 +15,10 @@ class ProductionManager
 	BuildingManager m_buildingManager;
 	std::deque<BuildOrderItem> m_newQueue;
 
-	int m_weapons;
-	int m_armor;
-
 	bool m_scoutRequested;
 	bool m_vikingRequested;
 	int m_scansRequested;
+	uint32_t m_defaultMacroNextLoop;	// 0 means run on the next step
 
 	//const sc2::Unit * getClosestUnitToPosition(const std::vector<const sc2::Unit *> & units, sc2::Point2D closestTo);
 	//bool	meetsReservedResources(const BuildType & type);
@@ -39,6 +38,7 @@ public:
 
 	void	onStart();
 	void	onFrame();
+	void	onUnitDeltas(const UnitDeltas & deltas);
 	void	onUnitDestroy(const sc2::Unit * unit);
 	void	drawProductionInformation();
 
@@ -50,6 +50,6 @@ public:
 	void requestVikings();
 	void requestScan();
 	void usedScan(const int i=1);
-	int buildingsFinished(sc2::Units units);
+	int buildingsFinished(const UnitSpan & units);
 	int howOftenQueued(sc2::UnitTypeID type);
 };
@@ -108,6 +108,7 @@ void RangedManager::assignTargets(const std::vector<const sc2::Unit *> & targets
 							fleeingPos = rangedUnit->pos + Util::normalizeVector(sc2::Point2D(-attackDirection.x,attackDirection.y), radius + 2.0f);
 						}
 						Micro::SmartMove(rangedUnit, fleeingPos, m_bot);
+						m_bot.requestFineStep();
 						fleeYouFools = true;
 						break;
 					}
@@ -153,7 +154,7 @@ void RangedManager::assignTargets(const std::vector<const sc2::Unit *> & targets
 					const sc2::Unit* mostInjured = (injuredUnits.rbegin())->second;
 					if (nearestEnemy && Util::Dist(rangedUnit->pos, nearestEnemy->pos) < Util::Dist(mostInjured->pos, nearestEnemy->pos))
 					{
-						m_bot.Actions()->UnitCommand(rangedUnit, sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS);
+						Micro::SmartCDAbility(rangedUnit, sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS, m_bot);
 						sc2::Point2D targetPos = rangedUnit->pos;
 						sc2::Point2D runningVector = mostInjured->pos - nearestEnemy->pos;
 						runningVector *= (Util::GetAttackRange(rangedUnit->unit_type,m_bot) - 1) / (std::sqrt(Util::DistSq(runningVector)));
@@ -162,7 +163,7 @@ void RangedManager::assignTargets(const std::vector<const sc2::Unit *> & targets
 					}
 					else if (Util::Dist(rangedUnit->pos, mostInjured->pos) > 5)
 					{
-						m_bot.Actions()->UnitCommand(rangedUnit, sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS);
+						Micro::SmartCDAbility(rangedUnit, sc2::ABILITY_ID::EFFECT_MEDIVACIGNITEAFTERBURNERS, m_bot);
 						if (rangedUnit->orders.empty() || rangedUnit->orders[0].target_unit_tag != mostInjured->tag)
 						{
 							m_bot.Actions()->UnitCommand(rangedUnit, sc2::ABILITY_ID::MOVE, mostInjured);
@@ -202,7 +203,7 @@ void RangedManager::assignTargets(const std::vector<const sc2::Unit *> & targets
 					}
 					if (order.getType() == SquadOrderTypes::Defend)
 					{
-						const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_BUNKER }));
+						const UnitSpan Bunker = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::Bunker);
 						if (Bunker.size() > 0 && Bunker.front()->cargo_space_taken != Bunker.front()->cargo_space_max)
 						{
 							if (Util::Dist(rangedUnit->pos, Bunker.front()->pos) < Util::Dist(rangedUnit->pos, target->pos))
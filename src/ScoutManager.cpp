@@ -16,7 +16,6 @@ ScoutManager::ScoutManager(CCBot & bot)
 	, m_numScouts	   (-1)
 	, m_scoutUnderAttack(false)
 	, m_scoutStatus	 ("None")
-	, m_previousScoutHP (0.0f)
 	, m_targetBasesPositions(std::queue<sc2::Point2D>())
 	, m_foundProxy(false)
 {
@@ -383,14 +382,11 @@ bool ScoutManager::enemyTooClose(std::vector<const sc2::Unit *> enemyUnitsInSigh
 	if (tooClose)
 	{
 		m_scoutStatus = "Too close to the fire! Retreating";
-		sc2::AvailableAbilities abilities = m_bot.Query()->GetAbilitiesForUnit(m_scoutUnit);
-		for (const auto & ability : abilities.abilities)
+		if (m_bot.Abilities().isReady(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE))
 		{
-			if (ability.ability_id == sc2::ABILITY_ID::EFFECT_KD8CHARGE)
-			{
-				m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE,enemyPositions[0]);
-				return tooClose;
-			}
+			m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE,enemyPositions[0]);
+			m_bot.Abilities().onCast(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE);
+			return tooClose;
 		}
 		sc2::Point2D clusterPosition = Util::CalcCenter(enemyPositions);
 		Micro::SmartMove(m_scoutUnit, m_scoutUnit->pos + (m_scoutUnit->pos - clusterPosition), m_bot);
@@ -424,14 +420,11 @@ bool ScoutManager::attackEnemyCombat(std::vector<const sc2::Unit *> enemyUnitsIn
 	if (attackingEnemy)
 	{
 		m_scoutStatus = "Found a victim (combat). Attacking!";
-		sc2::AvailableAbilities abilities = m_bot.Query()->GetAbilitiesForUnit(m_scoutUnit);
-		for (const auto & ability : abilities.abilities)
+		if (m_bot.Abilities().isReady(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE))
 		{
-			if (ability.ability_id == sc2::ABILITY_ID::EFFECT_KD8CHARGE)
-			{
-				m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE, lowestHealthUnit);
-				return attackingEnemy;
-			}
+			m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE, lowestHealthUnit);
+			m_bot.Abilities().onCast(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE);
+			return attackingEnemy;
 		}
 		
 		Micro::SmartKiteTarget(m_scoutUnit, lowestHealthUnit, m_bot);
@@ -485,14 +478,11 @@ bool ScoutManager::attackEnemyWorker(std::vector<const sc2::Unit *> enemyUnitsIn
 	if (lowestHealthUnit)
 	{
 		m_scoutStatus = "Found a victim (worker). Attacking!";
-		sc2::AvailableAbilities abilities = m_bot.Query()->GetAbilitiesForUnit(m_scoutUnit);
-		for (const auto & ability : abilities.abilities)
+		if (m_bot.Abilities().isReady(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE))
 		{
-			if (ability.ability_id == sc2::ABILITY_ID::EFFECT_KD8CHARGE)
-			{
-				m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE, lowestHealthUnit);
-				return true;
-			}
+			m_bot.Actions()->UnitCommand(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE, lowestHealthUnit);
+			m_bot.Abilities().onCast(m_scoutUnit, sc2::ABILITY_ID::EFFECT_KD8CHARGE);
+			return true;
 		}
 		if (enemyUnitsInSight.size() > 1)
 		{
@@ -571,6 +561,11 @@ void ScoutManager::updateNearestUnoccupiedBases(sc2::Point2D pos,int player)
 	std::map<int,const BaseLocation *> allTargetBases;
 	int numBasesEnemy = 0;
 	for (const auto & base : bases)
+	{
+		m_bot.Pathing().request(pos, base->getBasePosition());
+	}
+	std::vector<const BaseLocation *> unoccupiedBases;
+	for (const auto & base : bases)
 	{
 		if (base->isOccupiedByPlayer(player))
 		{
@@ -578,9 +573,21 @@ void ScoutManager::updateNearestUnoccupiedBases(sc2::Point2D pos,int player)
 		}
 		if (!(base->isOccupiedByPlayer(Players::Enemy)) && !(base->isOccupiedByPlayer(Players::Self)))
 		{
-			allTargetBases[base->getGroundDistance(pos)] = base;
+			unoccupiedBases.push_back(base);
 		}
 	}
+	// one metric for all bases: the engine's distances if it found a path to every base, our own map otherwise
+	std::vector<float> pathingDistances;
+	bool usePathing = true;
+	for (const auto & base : unoccupiedBases)
+	{
+		pathingDistances.push_back(m_bot.Pathing().getDistance(pos, base->getBasePosition()));
+		usePathing = usePathing && pathingDistances.back() >= 0.0f;
+	}
+	for (size_t i = 0; i < unoccupiedBases.size(); ++i)
+	{
+		allTargetBases[usePathing ? static_cast<int>(pathingDistances[i]) : unoccupiedBases[i]->getGroundDistance(pos)] = unoccupiedBases[i];
+	}
 	if (Util::IsWorkerType(m_scoutUnit->unit_type))
 	{
 		auto baseIt = allTargetBases.begin();
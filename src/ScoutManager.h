@@ -13,7 +13,6 @@ class ScoutManager
 	std::string	 m_scoutStatus;
 	int			 m_numScouts;
 	bool			m_scoutUnderAttack;
-	float		   m_previousScoutHP;
 	std::queue<sc2::Point2D> m_targetBasesPositions;
 	bool			m_foundProxy;
 
@@ -2,12 +2,16 @@
 #include "CCBot.h"
 #include "Util.h"
 
+// a regroup lasts at least a second of game time, whatever the step size
+const uint32_t minRetreatLoops = 22;
+
 Squad::Squad(CCBot & bot)
 	: m_bot(bot)
 	, m_lastRetreatSwitch(0)
 	, m_lastRetreatSwitchVal(false)
 	, m_priority(0)
 	, m_name("Default")
+	, m_profileName("Squad Default")
 	, m_meleeManager(bot)
 	, m_rangedManager(bot)
 	, m_siegeManager(bot)
@@ -18,6 +22,7 @@ Squad::Squad(CCBot & bot)
 Squad::Squad(const std::string & name, const SquadOrder & order, size_t priority, CCBot & bot)
 	: m_bot(bot)
 	, m_name(name)
+	, m_profileName("Squad " + name)
 	, m_order(order)
 	, m_lastRetreatSwitch(0)
 	, m_lastRetreatSwitchVal(false)
@@ -31,6 +36,7 @@ Squad::Squad(const std::string & name, const SquadOrder & order, size_t priority
 
 void Squad::onFrame()
 {
+	ProfileScope profile(m_bot.Profiler(), m_profileName);
 	// update all necessary unit information within this squad
 	updateUnits();
 
@@ -81,27 +87,21 @@ void Squad::setPriority(const size_t & priority)
 
 void Squad::updateUnits()
 {
-	setAllUnits();
 	setNearEnemyUnits();
 	addUnitsToMicroManagers();
 }
 
-void Squad::setAllUnits()
+void Squad::onUnitDeltas(const UnitDeltas & deltas)
 {
-	// clean up the _units vector just in case one of them died
-	std::set<const sc2::Unit *> goodUnits;
-	for (const auto & unit : m_units)
+	// clean up the _units set in case one of them died or went into a bunker or transport
+	for (const auto & unit : deltas.destroyed)
 	{
-		if (!unit) { continue; }
-		if (unit->build_progress < 1.0f) { continue; }
-		if (unit->health <= 0) { continue; }
-		if (unit->last_seen_game_loop != m_bot.Observation()->GetGameLoop()) { continue; }
-		if (m_order.getType() == SquadOrderTypes::Attack  && Util::IsWorker(unit)) { continue; }
-		if (unit->cargo_space_taken>0) { continue; } //This really should not happen. No idea, why the harass medivac gets here
-		goodUnits.insert(unit);
+		m_units.erase(unit);
+	}
+	for (const auto & unit : deltas.leftVision)
+	{
+		m_units.erase(unit);
 	}
-
-	m_units = goodUnits;
 }
 
 void Squad::setNearEnemyUnits()
@@ -125,9 +125,18 @@ void Squad::addUnitsToMicroManagers()
 	std::vector<const sc2::Unit *> siegeUnits;
 
 	// add _units to micro managers
-	for (const auto unit : m_units)
+	for (auto it = m_units.begin(); it != m_units.end();)
 	{
+		const sc2::Unit * unit = *it;
 		BOT_ASSERT(unit, "null unit in addUnitsToMicroManagers()");
+		if (unit->build_progress < 1.0f
+			|| (m_order.getType() == SquadOrderTypes::Attack && Util::IsWorker(unit))
+			|| unit->cargo_space_taken > 0) //This really should not happen. No idea, why the harass medivac gets here
+		{
+			it = m_units.erase(it);
+			continue;
+		}
+		++it;
 		if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_SIEGETANK || unit->unit_type == sc2::UNIT_TYPEID::TERRAN_SIEGETANKSIEGED)
 		{
 			siegeUnits.push_back(unit);
@@ -163,7 +172,7 @@ const bool Squad::needsToRegroup()
 	}
 	if (m_units.size() < 100 && m_units.size()<m_bot.UnitInfo().getNumCombatUnits(Players::Enemy))
 	{
-		m_lastRetreatSwitchVal = true;
+		setRetreating(true);
 		return m_lastRetreatSwitchVal;
 	}
 	float n = 0.0f;
@@ -188,24 +197,35 @@ const bool Squad::needsToRegroup()
 	//if we are retreating, we want to do it for a while
 	if (m_lastRetreatSwitchVal)
 	{
-		if (scattering < 1)
+		if (scattering < 1 && m_bot.Observation()->GetGameLoop() >= m_lastRetreatSwitch + minRetreatLoops)
 		{
-			m_lastRetreatSwitchVal = false;
+			setRetreating(false);
 		}
 	}
 	else
 	{
 		if (scattering > 4)
 		{
-			m_lastRetreatSwitchVal = true;
+			setRetreating(true);
 		}
 	}
 	return m_lastRetreatSwitchVal;
 }
 
+void Squad::setRetreating(const bool retreat)
+{
+	if (retreat != m_lastRetreatSwitchVal)
+	{
+		m_lastRetreatSwitchVal = retreat;
+		m_lastRetreatSwitch = m_bot.Observation()->GetGameLoop();
+	}
+}
+
 void Squad::setSquadOrder(const SquadOrder & so)
 {
 	m_order = so;
+	// unitClosestToEnemy needs the distance map of the order position
+	m_bot.Map().requestDistanceMap(m_order.getPosition());
 }
 
 bool Squad::containsUnit(const sc2::Unit * unit) const
@@ -7,15 +7,17 @@
 #include "SquadOrder.h"
 
 class CCBot;
+struct UnitDeltas;
 
 class Squad
 {
 	CCBot &			 m_bot;
 
 	std::string		 m_name;
+	std::string		 m_profileName;	// "Squad " + m_name, so onFrame does not build it every frame
 	std::set<const sc2::Unit *> m_units;
 	std::string		 m_regroupStatus;
-	int				 m_lastRetreatSwitch;
+	uint32_t			 m_lastRetreatSwitch;	// game loop the regroup decision last changed
 	bool				m_lastRetreatSwitchVal;
 	size_t			  m_priority;
 
@@ -31,10 +33,10 @@ class Squad
 	void updateUnits();
 	void addUnitsToMicroManagers();
 	void setNearEnemyUnits();
-	void setAllUnits();
 
 	bool isUnitNearEnemy(const sc2::Unit * unit) const;
 	const bool needsToRegroup();
+	void setRetreating(const bool retreat);
 	int  squadUnitsNear(const sc2::Point2D & pos) const;
 
 public:
@@ -43,6 +45,7 @@ public:
 	Squad(CCBot & bot);
 
 	void onFrame();
+	void onUnitDeltas(const UnitDeltas & deltas);
 	void setSquadOrder(const SquadOrder & so);
 	void addUnit(const sc2::Unit * unit);
 	void removeUnit(const sc2::Unit * unit);
@@ -15,6 +15,14 @@ void SquadData::onFrame()
 	drawSquadInformation();
 }
 
+void SquadData::onUnitDeltas(const UnitDeltas & deltas)
+{
+	for (auto & kv : m_squads)
+	{
+		kv.second.onUnitDeltas(deltas);
+	}
+}
+
 void SquadData::clearSquadData()
 {
 	// give back workers who were in squads
@@ -73,11 +81,52 @@ void SquadData::addSquad(const std::string & squadName, const Squad & squad)
 	m_squads.insert(std::pair<std::string, Squad>(squadName, squad));
 }
 
+// the squads share no state, so they can decide in parallel. Each one records its commands,
+// the lists are handed to the command buffer in squad order, so the result does not depend on the timing.
 void SquadData::updateAllSquads()
 {
+	std::vector<Squad *> squads;
+	size_t activeSquads = 0;
 	for (auto & kv : m_squads)
 	{
-		kv.second.onFrame();
+		squads.push_back(&kv.second);
+		activeSquads += kv.second.isEmpty() ? 0 : 1;
+	}
+	if (!m_bot.Config().ParallelSquadMicro || activeSquads < 2)
+	{
+		for (const auto & squad : squads)
+		{
+			squad->onFrame();
+		}
+		return;
+	}
+
+	std::vector<CommandBuffer::CommandList> commands(squads.size());
+	std::vector<std::future<void>> jobs;
+	const std::string zone = ModuleProfiler::currentZone();
+	for (size_t i = 1; i < squads.size(); ++i)
+	{
+		Squad * squad = squads[i];
+		CommandBuffer::CommandList * list = &commands[i];
+		jobs.push_back(m_bot.Threads().submit([this, squad, list, zone]()
+		{
+			ProfileContext profile(m_bot.Profiler(), zone);
+			CommandBuffer::Recorder recorder(*list);
+			squad->onFrame();
+		}));
+	}
+	// the main thread takes the first one instead of waiting
+	{
+		CommandBuffer::Recorder recorder(commands[0]);
+		squads[0]->onFrame();
+	}
+	for (auto & job : jobs)
+	{
+		job.get();
+	}
+	for (const auto & list : commands)
+	{
+		m_bot.Actions()->append(list);
 	}
 }
 
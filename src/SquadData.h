@@ -18,6 +18,7 @@ public:
 	SquadData(CCBot & bot);
 
 	void			onFrame();
+	void			onUnitDeltas(const UnitDeltas & deltas);
 	void			clearSquadData();
 
 	bool			canAssignUnitToSquad(const sc2::Unit * unit, const Squad & squad) const;
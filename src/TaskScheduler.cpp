@@ -0,0 +1,166 @@
+#include "TaskScheduler.h"
+#include "CCBot.h"
+#include "Timer.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// how fast the estimated cost of a task follows its measured time
+const double costSmoothing = 0.2;
+
+TaskScheduler::TaskScheduler(CCBot & bot)
+	: m_bot(bot)
+	, m_misses(0)
+	, m_pipelined(false)
+	, m_runningAhead(false)
+	, m_replaying(false)
+{
+
+}
+
+void TaskScheduler::addTask(const std::string & name, uint32_t period, TaskPriority priority, double estimatedCost, const std::function<void()> & run, bool latencyTolerant)
+{
+	BOT_ASSERT(period > 0, "Task %s needs a period", name.c_str());
+	// start behind the tasks with the same period, so they do not all run in the same loop
+	const uint32_t samePeriod = static_cast<uint32_t>(std::count_if(m_tasks.begin(), m_tasks.end(), [period](const Task & task) { return task.period == period; }));
+	const uint32_t nextLoop = m_bot.Observation()->GetGameLoop() + samePeriod % period;
+	m_tasks.push_back({ name, period, priority, latencyTolerant, estimatedCost, run, nextLoop, 0, 0, 0 });
+}
+
+void TaskScheduler::setPipelined(bool pipelined)
+{
+	m_pipelined = pipelined;
+}
+
+bool TaskScheduler::isRunningAhead() const
+{
+	return m_runningAhead;
+}
+
+void TaskScheduler::deferQuery(const std::function<void()> & query)
+{
+	m_deferredQueries.push_back(query);
+}
+
+const std::vector<uint32_t> & TaskScheduler::getLastRun() const
+{
+	return m_lastRun;
+}
+
+void TaskScheduler::replayNextRun(const std::vector<uint32_t> & tasks)
+{
+	m_replay = tasks;
+	m_replaying = true;
+}
+
+void TaskScheduler::onFrame()
+{
+	std::vector<std::function<void()>> deferred;
+	deferred.swap(m_deferredQueries);
+	for (const auto & query : deferred)
+	{
+		query();
+	}
+	run(false);
+	drawInfo();
+}
+
+void TaskScheduler::onFrameAhead()
+{
+	m_runningAhead = true;
+	run(true);
+	m_runningAhead = false;
+}
+
+void TaskScheduler::run(bool latencyTolerant)
+{
+	Timer t;
+	t.start();
+	const uint32_t gameLoop = m_bot.Observation()->GetGameLoop();
+	const double budget = static_cast<double>(m_bot.Config().StepTimeBudget);
+
+	// pick the most important due tasks that fit. A task that would miss its deadline is picked in any case
+	std::vector<size_t> due;
+	for (size_t i = 0; i < m_tasks.size(); ++i)
+	{
+		if (m_tasks[i].nextLoop <= gameLoop && (!m_pipelined || m_tasks[i].latencyTolerant == latencyTolerant))
+		{
+			due.push_back(i);
+		}
+	}
+	std::stable_sort(due.begin(), due.end(), [this](size_t a, size_t b) { return m_tasks[a].priority < m_tasks[b].priority; });
+	std::vector<bool> selected(m_tasks.size(), false);
+	double planned = 0.0;
+	if (m_replaying)
+	{
+		m_replaying = false;
+		due.clear();
+		for (const auto i : m_replay)
+		{
+			if (i < m_tasks.size())
+			{
+				selected[i] = true;
+			}
+		}
+	}
+	for (const auto i : due)
+	{
+		Task & task = m_tasks[i];
+		const bool overdue = gameLoop >= task.nextLoop + task.period;
+		if (task.priority == TaskPriority::Critical || overdue || planned + task.cost <= budget)
+		{
+			selected[i] = true;
+			planned += task.cost;
+			if (overdue)
+			{
+				++task.misses;
+				++m_misses;
+			}
+		}
+		else
+		{
+			++task.postponed;
+		}
+	}
+
+	m_lastRun.clear();
+	for (size_t i = 0; i < m_tasks.size(); ++i)
+	{
+		if (!selected[i])
+		{
+			continue;
+		}
+		m_lastRun.push_back(static_cast<uint32_t>(i));
+		Task & task = m_tasks[i];
+		const double start = t.getElapsedTimeInMilliSec();
+		{
+			ProfileScope profile(m_bot.Profiler(), task.name);
+			task.run();
+		}
+		const double ms = t.getElapsedTimeInMilliSec() - start;
+		task.cost += costSmoothing * (ms - task.cost);
+		++task.runs;
+		// stay on the grid, so the tasks remain spread
+		while (task.nextLoop <= gameLoop)
+		{
+			task.nextLoop += task.period;
+		}
+	}
+}
+
+void TaskScheduler::drawInfo() const
+{
+	if (!m_bot.Config().DrawModuleTimers)
+	{
+		return;
+	}
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	for (const auto & task : m_tasks)
+	{
+		ss << task.name << ": " << task.cost << "ms, " << task.runs << " runs, " << task.postponed << " postponed, " << task.misses << " missed\n";
+	}
+	ss << "Deadline misses: " << m_misses;
+	Drawing::drawTextScreen(m_bot, sc2::Point2D(0.01f, 0.6f), ss.str());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+class CCBot;
+
+// in order of importance. Critical tasks run whenever they are due, no matter the budget
+enum class TaskPriority { Critical, High, Normal, Low };
+
+// runs the manager updates. Each task is due every period game loops, tasks with the same period are spread over the loops.
+// Due tasks that do not fit into StepTimeBudget wait for a later step, unless they would miss their deadline.
+// Tasks of one step run in the order they were added.
+// When pipelining, latency tolerant tasks run in onFrameAhead while the game simulates the next step, the others in onFrame.
+// The game does not answer queries while it simulates, so tasks running ahead defer them to the next onFrame.
+class TaskScheduler
+{
+	struct Task
+	{
+		std::string				name;
+		uint32_t				period;
+		TaskPriority			priority;
+		bool					latencyTolerant;
+		double					cost;		// estimated ms, follows the measured time
+		std::function<void()>	run;
+		uint32_t				nextLoop;
+		size_t					runs;
+		size_t					postponed;
+		size_t					misses;
+	};
+
+	CCBot &				m_bot;
+	std::vector<Task>	m_tasks;
+	size_t				m_misses;
+	bool				m_pipelined;
+	bool				m_runningAhead;
+	std::vector<std::function<void()>>	m_deferredQueries;
+	std::vector<uint32_t>	m_lastRun;
+	std::vector<uint32_t>	m_replay;
+	bool				m_replaying;
+
+	void	run(bool latencyTolerant);
+	void	drawInfo() const;
+
+public:
+
+	TaskScheduler(CCBot & bot);
+
+	void	addTask(const std::string & name, uint32_t period, TaskPriority priority, double estimatedCost, const std::function<void()> & run, bool latencyTolerant = false);
+	void	onFrame();
+	void	onFrameAhead();
+	void	setPipelined(bool pipelined);
+	// true during onFrameAhead. Query the game only if this is false
+	bool	isRunningAhead() const;
+	// runs query at the start of the next onFrame, when the game answers again
+	void	deferQuery(const std::function<void()> & query);
+	// the tasks the last onFrame or onFrameAhead ran, by the order they were added
+	const std::vector<uint32_t> &	getLastRun() const;
+	// the next run picks these tasks instead of choosing by the time budget, so a recorded game replays the same
+	void	replayNextRun(const std::vector<uint32_t> & tasks);
+};
@@ -0,0 +1,49 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t numThreads)
+	: m_stop(false)
+{
+	if (numThreads == 0)
+	{
+		const unsigned hardwareThreads = std::thread::hardware_concurrency();
+		numThreads = hardwareThreads > 2 ? hardwareThreads - 1 : 1;
+	}
+	for (size_t i = 0; i < numThreads; ++i)
+	{
+		m_threads.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+// jobs that did not start yet are dropped, their futures report a broken promise
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_jobs = std::queue<std::function<void()>>();
+	}
+	m_condition.notify_all();
+	for (auto & thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::work()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+			if (m_stop)
+			{
+				return;
+			}
+			job = std::move(m_jobs.front());
+			m_jobs.pop();
+		}
+		job();
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// runs jobs in the background. A job must not touch the bot or the game, only the data it was handed,
+// and that data must not change until the job is done. The result is picked up on a later frame.
+class ThreadPool
+{
+	std::vector<std::thread>			m_threads;
+	std::queue<std::function<void()>>	m_jobs;
+	std::mutex							m_mutex;
+	std::condition_variable				m_condition;
+	bool								m_stop;
+
+	void	work();
+
+public:
+
+	// 0 uses all hardware threads but the one running the bot
+	ThreadPool(size_t numThreads = 0);
+	~ThreadPool();
+
+	template <class Job>
+	auto submit(Job job) -> std::future<decltype(job())>
+	{
+		using Result = decltype(job());
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(job));
+		std::future<Result> result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push([task]() { (*task)(); });
+		}
+		m_condition.notify_one();
+		return result;
+	}
+
+	template <class Result>
+	static bool isReady(const std::future<Result> & result)
+	{
+		return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+};
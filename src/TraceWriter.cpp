@@ -0,0 +1,108 @@
+#include "TraceWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// events kept per thread, about 1 MB each
+const size_t traceCapacity = 16384;
+
+// a new writer per game, so threads notice that their buffer belongs to an old one
+std::atomic<size_t> writerCount(0);
+
+TraceWriter::ThreadBuffer::ThreadBuffer(size_t capacity, size_t id)
+	: events(capacity)
+	, written(0)
+	, threadId(id)
+{
+
+}
+
+TraceWriter::TraceWriter()
+	: m_id(++writerCount)
+	, m_begin(std::chrono::steady_clock::now())
+	, m_enabled(false)
+{
+
+}
+
+void TraceWriter::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+bool TraceWriter::isEnabled() const
+{
+	return m_enabled;
+}
+
+uint64_t TraceWriter::now() const
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_begin).count());
+}
+
+TraceWriter::ThreadBuffer & TraceWriter::getThreadBuffer()
+{
+	static thread_local size_t writerId = 0;
+	static thread_local ThreadBuffer * buffer = nullptr;
+	if (writerId != m_id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_buffers.push_back(std::make_unique<ThreadBuffer>(traceCapacity, m_buffers.size()));
+		buffer = m_buffers.back().get();
+		writerId = m_id;
+	}
+	return *buffer;
+}
+
+void TraceWriter::add(const std::string & name, const char * category, uint64_t start, uint64_t duration)
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+	ThreadBuffer & buffer = getThreadBuffer();
+	const size_t index = buffer.written.load(std::memory_order_relaxed);
+	TraceEvent & event = buffer.events[index % buffer.events.size()];
+	const size_t length = std::min(name.size(), sizeof(event.name) - 1);
+	std::memcpy(event.name, name.c_str(), length);
+	event.name[length] = '\0';
+	event.category = category;
+	event.start = start;
+	event.duration = duration;
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool TraceWriter::write(const std::string & fileName) const
+{
+	std::ofstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const auto & buffer : m_buffers)
+	{
+		const size_t written = buffer->written.load(std::memory_order_acquire);
+		const size_t capacity = buffer->events.size();
+		for (size_t i = written > capacity ? written - capacity : 0; i < written; ++i)
+		{
+			const TraceEvent & event = buffer->events[i % capacity];
+			file << (first ? "\n" : ",\n") << "{\"name\":\"";
+			for (const char * c = event.name; *c; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					file << '\\';
+				}
+				file << *c;
+			}
+			file << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+				<< ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return true;
+}
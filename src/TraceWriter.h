@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// one finished zone, a complete event in the Chrome trace format
+struct TraceEvent
+{
+	char		name[40];
+	const char *	category;
+	uint64_t	start;		// microseconds since the writer was created
+	uint64_t	duration;
+};
+
+// keeps the last events of every thread and writes them as Chrome trace-event JSON, open it in chrome://tracing or Perfetto.
+// Each thread appends to its own ring buffer without locking, the lock is only taken when a thread adds its buffer.
+class TraceWriter
+{
+	struct ThreadBuffer
+	{
+		std::vector<TraceEvent>	events;
+		std::atomic<size_t>		written;
+		size_t					threadId;
+
+		ThreadBuffer(size_t capacity, size_t id);
+	};
+
+	const size_t								m_id;
+	const std::chrono::steady_clock::time_point	m_begin;
+	bool										m_enabled;
+	std::vector<std::unique_ptr<ThreadBuffer>>	m_buffers;
+	mutable std::mutex							m_mutex;
+
+	ThreadBuffer &	getThreadBuffer();
+
+public:
+
+	TraceWriter();
+
+	void		setEnabled(bool enabled);
+	bool		isEnabled() const;
+	uint64_t	now() const;
+	void		add(const std::string & name, const char * category, uint64_t start, uint64_t duration);
+	// threads still running jobs may overwrite their oldest events meanwhile
+	bool		write(const std::string & fileName) const;
+};
@@ -1,6 +1,13 @@
 #include "UnitData.h"
 #include "Util.h"
 
+// we only extrapolate the velocity for about 3 seconds, after that the unit most likely changed its mind
+const float predictionHorizon = 67.0f;
+// if a unit could be anywhere in this radius we do not know anything about it
+const float maxUncertainty = 20.0f;
+// a building we do not find where it was is forgotten after about 2 seconds
+const float buildingForgetLoops = 45.0f;
+
 UnitData::UnitData()
 	: m_mineralsLost(0)
 	, m_gasLost(0)
@@ -10,7 +17,7 @@ UnitData::UnitData()
 	m_numUnits			= std::vector<int>(maxTypeID + 1, 0);
 }
 
-void UnitData::updateUnit(const sc2::Unit * unit)
+const UnitInfo & UnitData::updateUnit(const sc2::Unit * unit)
 {
 
 	bool firstSeen = false;
@@ -22,9 +29,29 @@ void UnitData::updateUnit(const sc2::Unit * unit)
 	}
 
 	UnitInfo & ui = m_unitMap[unit];
+	const bool hadPosition = !firstSeen && !(ui.lastPosition.x == 0.0f && ui.lastPosition.y == 0.0f);
+	if (hadPosition && unit->last_seen_game_loop > ui.lastSeen)
+	{
+		const float dt = static_cast<float>(unit->last_seen_game_loop - ui.lastSeen);
+		const sc2::Point2D step(unit->pos.x - ui.lastPosition.x, unit->pos.y - ui.lastPosition.y);
+		// smooth it a bit, a single frame is too noisy. After a longer gap we start over.
+		ui.velocity = dt <= 22.0f ? (ui.velocity + step / dt) * 0.5f : sc2::Point2D(0.0f, 0.0f);
+	}
+	else if (!hadPosition)
+	{
+		ui.velocity = sc2::Point2D(0.0f, 0.0f);
+	}
+	ui.lastSeen = unit->last_seen_game_loop;
+	ui.predictedPosition = unit->pos;
+	ui.uncertainty = 0.0f;
+	ui.confidence = 1.0f;
+	ui.missingSince = 0;
 	ui.unit = unit;
 	ui.player = Util::GetPlayer(unit);
 	ui.lastPosition = unit->pos;
+	// healing and regeneration do not count
+	ui.healthLost = firstSeen ? 0.0f : std::max(0.0f, ui.lastHealth - unit->health);
+	ui.shieldLost = firstSeen ? 0.0f : std::max(0.0f, ui.lastShields - unit->shield);
 	ui.lastHealth = unit->health;
 	ui.lastShields = unit->shield;
 	ui.tag = unit->tag;
@@ -34,6 +61,7 @@ void UnitData::updateUnit(const sc2::Unit * unit)
 	{
 		m_numUnits[ui.type]++;
 	}
+	return ui;
 }
 
 void UnitData::killUnit(const sc2::Unit * unit)
@@ -54,6 +82,46 @@ void UnitData::lostPosition(const sc2::Unit * unit)
 
 	UnitInfo & ui = m_unitMap[unit];
 	ui.lastPosition = sc2::Point3D(0.0f,0.0f,0.0f);
+	ui.predictedPosition = sc2::Point2D(0.0f, 0.0f);
+	ui.velocity = sc2::Point2D(0.0f, 0.0f);
+	ui.confidence = 0.0f;
+}
+
+// its spot is visible but the building is not there anymore. It might have been destroyed out of sight.
+void UnitData::missingBuilding(const sc2::Unit * unit, uint32_t currentLoop)
+{
+	const auto & it = m_unitMap.find(unit);
+	BOT_ASSERT(it != m_unitMap.end(), "We should not have a snapshot of unit we have never seen!");
+
+	if (it->second.missingSince == 0)
+	{
+		it->second.missingSince = currentLoop;
+	}
+}
+
+// one pass over all units we can not see at the moment
+void UnitData::predictPositions(uint32_t currentLoop, const sc2::UnitTypes & unitTypes, const sc2::Point2D & playableMin, const sc2::Point2D & playableMax)
+{
+	for (auto & kv : m_unitMap)
+	{
+		UnitInfo & ui = kv.second;
+		if (ui.lastSeen >= currentLoop || (ui.lastPosition.x == 0.0f && ui.lastPosition.y == 0.0f))
+		{
+			continue;
+		}
+		const float dt = static_cast<float>(currentLoop - ui.lastSeen);
+		// movement_speed is given per normal speed second, which has 16 game loops
+		const float speed = static_cast<uint32_t>(ui.type) < unitTypes.size() ? unitTypes[ui.type].movement_speed / 16.0f : 0.0f;
+		ui.predictedPosition = sc2::Point2D(ui.lastPosition.x, ui.lastPosition.y) + ui.velocity * std::min(dt, predictionHorizon);
+		ui.predictedPosition.x = std::max(playableMin.x, std::min(ui.predictedPosition.x, playableMax.x));
+		ui.predictedPosition.y = std::max(playableMin.y, std::min(ui.predictedPosition.y, playableMax.y));
+		ui.uncertainty = std::min(speed * dt, maxUncertainty);
+		ui.confidence = 1.0f - ui.uncertainty / maxUncertainty;
+		if (ui.missingSince > 0)
+		{
+			ui.confidence = std::max(0.0f, std::min(ui.confidence, 1.0f - (currentLoop - ui.missingSince) / buildingForgetLoops));
+		}
+	}
 }
 
 void UnitData::removeBadUnits()
@@ -79,6 +147,11 @@ bool UnitData::badUnitInfo(const UnitInfo & ui) const
 	{
 		return true;
 	}
+	// a building that was not where we saw it for long enough
+	if (ui.missingSince > 0 && ui.confidence == 0.0f)
+	{
+		return true;
+	}
 	return false;
 }
 
@@ -16,6 +16,18 @@ struct UnitInfo
 	sc2::UnitTypeID type;
 	float		   progress;
 
+	// motion model for units in the fog
+	uint32_t		lastSeen;
+	sc2::Point2D	velocity;			// tiles per game loop
+	sc2::Point2D	predictedPosition;
+	float		   uncertainty;		// radius around predictedPosition the unit could have moved in
+	float		   confidence;		 // 1 while visible, 0 if we have no idea where it is
+	uint32_t		missingSince;		// loop we first saw the spot of a building without it, 0 while it is there
+
+	// damage taken since the previous update
+	float		   healthLost;
+	float		   shieldLost;
+
 	UnitInfo()
 		: tag(0)
 		, lastHealth(0)
@@ -23,6 +35,14 @@ struct UnitInfo
 		, lastPosition(sc2::Point3D(0, 0, 0))
 		, type(0)
 		, progress(1.0)
+		, lastSeen(0)
+		, velocity(0.0f, 0.0f)
+		, predictedPosition(0.0f, 0.0f)
+		, uncertainty(0.0f)
+		, confidence(0.0f)
+		, missingSince(0)
+		, healthLost(0.0f)
+		, shieldLost(0.0f)
 	{
 
 	}
@@ -59,10 +79,12 @@ public:
 
 	UnitData();
 
-	void	updateUnit(const sc2::Unit * unit);
+	const UnitInfo & updateUnit(const sc2::Unit * unit);
 	void	killUnit(const sc2::Unit * unit);
 	void	lostPosition(const sc2::Unit * unit);
+	void	missingBuilding(const sc2::Unit * unit, uint32_t currentLoop);
 	void	removeBadUnits();
+	void	predictPositions(uint32_t currentLoop, const sc2::UnitTypes & unitTypes, const sc2::Point2D & playableMin, const sc2::Point2D & playableMax);
 
 	int		getGasLost()								const;
 	int		getMineralsLost()						   const;
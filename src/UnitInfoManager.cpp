@@ -4,11 +4,19 @@
 
 #include <sstream>
 
+// the longest ranges are around 13 plus the radii of both units
+const float maxAttackerDistance = 16.0f;
 
 UnitInfoManager::UnitInfoManager(CCBot & bot)
 	: m_bot(bot)
 {
-
+	m_unitIndex[Players::Self] = UnitIndex();
+	m_unitIndex[Players::Enemy] = UnitIndex();
+	m_numUpgrades = 0;
+	m_infantryWeapons = 0;
+	m_infantryArmor = 0;
+	m_infantryWeaponsResearching = false;
+	m_infantryArmorResearching = false;
 }
 
 void UnitInfoManager::onStart()
@@ -16,8 +24,20 @@ void UnitInfoManager::onStart()
 
 }
 
+// the callbacks arrive before the step, they are published together with the diff in updateUnitDeltas
+void UnitInfoManager::onUnitDestroyed(const sc2::Unit * unit)
+{
+	m_pendingDeltas.destroyed.push_back(unit);
+}
+
+void UnitInfoManager::onUnitIdle(const sc2::Unit * unit)
+{
+	m_pendingDeltas.idle.push_back(unit);
+}
+
 void UnitInfoManager::onFrame()
 {
+	ProfileScope profile(m_bot.Profiler(), "UnitInfo");
 	updateUnitInfo();
 	drawUnitInformation(100, 100);
 	drawSelectedUnitDebugInfo();
@@ -28,48 +48,60 @@ void UnitInfoManager::updateUnitInfo()
 	m_units[Players::Self].clear();
 	m_units[Players::Enemy].clear();
 
-	//DT detection
-	const std::vector<sc2::UpgradeID> upgrades = m_bot.Observation()->GetUpgrades();
-	int armor = 0;
-	if (std::find(upgrades.begin(), upgrades.end(), sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL3) != upgrades.end())
-	{
-		armor = 3;
-	}
-	else if (std::find(upgrades.begin(), upgrades.end(), sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2) != upgrades.end())
-	{
-		armor = 2;
-	}
-	else if (std::find(upgrades.begin(), upgrades.end(), sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1) != upgrades.end())
+	updateUpgrades();
+
+	m_damageEvents.clear();
+
+	sc2::Units units;
 	{
-		armor = 1;
+		ProfileScope query(m_bot.Profiler(), "GetUnits", "api");
+		units = m_bot.Observation()->GetUnits();
 	}
-	if (m_bot.GetPlayerRace(Players::Enemy) == sc2::Race::Protoss && m_unitData.size() > 1)
+	for (auto & unit : units)
 	{
-		for (const auto & kv : getUnitData(Players::Self).getUnitInfoMap())
+		if (Util::GetPlayer(unit) == Players::Self || Util::GetPlayer(unit) == Players::Enemy)
 		{
-			const float lostHealth = kv.second.lastHealth - kv.first->health;
-			if (lostHealth == 45.0f-armor || lostHealth == 50.0f - armor || lostHealth == 55.0f - armor || lostHealth == 60.0f - armor)
-			{
-				m_bot.OnDTdetected(kv.first->pos);
-			}
+			updateUnit(unit);
+			m_units[Util::GetPlayer(unit)].push_back(unit);
 		}
 	}
-
-	for (auto & unit : m_bot.Observation()->GetUnits())
+	updateUnitIndex(Players::Self);
+	updateUnitIndex(Players::Enemy);
+	updateResearch();
+	updateDamageEvents();
+	detectDTs();
+	updateUnitDeltas();
+
+	// dead units do not show up in the observation anymore
+	for (const auto & unit : m_deltas.destroyed)
 	{
-		if (Util::GetPlayer(unit) == Players::Self || Util::GetPlayer(unit) == Players::Enemy)
+		const int player = Util::GetPlayer(unit);
+		if (m_unitData.find(player) != m_unitData.end() && getUnitData(player).getUnitInfoMap().count(unit) > 0)
 		{
-			updateUnit(unit);
-			m_units[Util::GetPlayer(unit)].push_back(unit);
+			m_unitData[player].killUnit(unit);
 		}
 	}
 
-	// Update the location of units we can not see now and the last seen position is visible
+	// Update the location of units we can not see now and the predicted position is visible
 	if (m_unitData.size() > 1)
 	{
+		const uint32_t currentLoop = m_bot.Observation()->GetGameLoop();
+		const sc2::GameInfo & gameInfo = m_bot.Observation()->GetGameInfo();
+		const sc2::Point2D playableMin(static_cast<float>(gameInfo.playable_min.x), static_cast<float>(gameInfo.playable_min.y));
+		const sc2::Point2D playableMax(static_cast<float>(gameInfo.playable_max.x), static_cast<float>(gameInfo.playable_max.y));
+		m_unitData[Players::Enemy].predictPositions(currentLoop, m_bot.Observation()->GetUnitTypeData(), playableMin, playableMax);
 		for (auto& kv : getUnitData(Players::Enemy).getUnitInfoMap())
 		{
-			if (kv.first->last_seen_game_loop!=m_bot.Observation()->GetGameLoop() && !Util::IsBuildingType(kv.second.type, m_bot) && !Util::IsBurrowedType(kv.second.type) && m_bot.Observation()->GetVisibility(kv.second.lastPosition) == sc2::Visibility::Visible)
+			if (kv.first->last_seen_game_loop == currentLoop || Util::IsBurrowedType(kv.second.type) || kv.second.confidence == 0.0f || m_bot.Observation()->GetVisibility(kv.second.predictedPosition) != sc2::Visibility::Visible)
+			{
+				continue;
+			}
+			// buildings keep their last position, we forget them when they stay missing
+			if (Util::IsBuildingType(kv.second.type, m_bot))
+			{
+				m_unitData[Players::Enemy].missingBuilding(kv.first, currentLoop);
+			}
+			else
 			{
 				m_unitData[Players::Enemy].lostPosition(kv.first);
 			}
@@ -92,6 +124,381 @@ const std::vector<const sc2::Unit *> & UnitInfoManager::getUnits(int player) con
 
 	return m_units.at(player);
 }
+void UnitInfoManager::updateUnitIndex(int player)
+{
+	UnitIndex & index = m_unitIndex[player];
+
+	// clear everything but keep the memory from the last frame
+	index.units.clear();
+	for (auto & category : index.categories)
+	{
+		category.clear();
+	}
+	std::fill(index.typeRange.begin(), index.typeRange.end(), std::pair<size_t, size_t>(0, 0));
+	std::fill(index.aliasRange.begin(), index.aliasRange.end(), std::pair<size_t, size_t>(0, 0));
+
+	for (const auto & unit : m_units[player])
+	{
+		index.units.push_back(unit);
+		if (Util::IsTownHallType(unit->unit_type) && !unit->is_flying)
+		{
+			index.categories[UnitCategory::TownHall].push_back(unit);
+		}
+		if (Util::IsProductionBuildingType(unit->unit_type))
+		{
+			index.categories[UnitCategory::Production].push_back(unit);
+		}
+		if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BUNKER)
+		{
+			index.categories[UnitCategory::Bunker].push_back(unit);
+		}
+		if (unit->is_flying && Util::IsBuildingType(unit->unit_type, m_bot))
+		{
+			index.categories[UnitCategory::FlyingBuilding].push_back(unit);
+		}
+	}
+
+	// sorting by alias first keeps e.g. depots and lowered depots next to each other
+	std::sort(index.units.begin(), index.units.end(), [](const sc2::Unit * a, const sc2::Unit * b)
+	{
+		const uint32_t aliasA = Util::GetAliasType(a->unit_type);
+		const uint32_t aliasB = Util::GetAliasType(b->unit_type);
+		if (aliasA != aliasB)
+		{
+			return aliasA < aliasB;
+		}
+		if (a->unit_type != b->unit_type)
+		{
+			return static_cast<uint32_t>(a->unit_type) < static_cast<uint32_t>(b->unit_type);
+		}
+		return a->tag < b->tag;
+	});
+
+	for (size_t i = 0; i < index.units.size(); ++i)
+	{
+		const uint32_t type = index.units[i]->unit_type;
+		const uint32_t alias = Util::GetAliasType(type);
+		const size_t maxType = std::max(type, alias);
+		if (maxType >= index.typeRange.size())
+		{
+			index.typeRange.resize(maxType + 1, std::pair<size_t, size_t>(0, 0));
+			index.aliasRange.resize(maxType + 1, std::pair<size_t, size_t>(0, 0));
+		}
+		if (i == 0 || static_cast<uint32_t>(index.units[i - 1]->unit_type) != type)
+		{
+			index.typeRange[type].first = i;
+		}
+		if (i == 0 || static_cast<uint32_t>(Util::GetAliasType(index.units[i - 1]->unit_type)) != alias)
+		{
+			index.aliasRange[alias].first = i;
+		}
+		index.typeRange[type].second = i + 1;
+		index.aliasRange[alias].second = i + 1;
+	}
+}
+
+void UnitInfoManager::updateUnitDeltas()
+{
+	const uint32_t currentLoop = m_bot.Observation()->GetGameLoop();
+
+	m_deltas.clear();
+	std::swap(m_deltas.destroyed, m_pendingDeltas.destroyed);
+	std::swap(m_deltas.idle, m_pendingDeltas.idle);
+
+	for (const auto & unit : m_deltas.destroyed)
+	{
+		m_trackedUnits.erase(unit);
+	}
+
+	for (const int player : { Players::Self, Players::Enemy })
+	{
+		for (const auto & unit : m_units[player])
+		{
+			if (!unit->is_alive)
+			{
+				continue;
+			}
+			const bool visible = unit->display_type == sc2::Unit::DisplayType::Visible;
+			const auto it = m_trackedUnits.find(unit);
+			if (it == m_trackedUnits.end())
+			{
+				m_trackedUnits[unit] = { unit->unit_type, visible, currentLoop };
+				if (player == Players::Self)
+				{
+					m_deltas.created.push_back(unit);
+				}
+				else if (visible)
+				{
+					m_deltas.enteredVision.push_back(unit);
+				}
+				continue;
+			}
+			TrackedUnit & tracked = it->second;
+			if (tracked.type != unit->unit_type)
+			{
+				m_deltas.morphed.push_back(unit);
+				tracked.type = unit->unit_type;
+			}
+			if (visible && !tracked.visible)
+			{
+				m_deltas.enteredVision.push_back(unit);
+			}
+			else if (!visible && tracked.visible)
+			{
+				m_deltas.leftVision.push_back(unit);
+			}
+			tracked.visible = visible;
+			tracked.lastUpdate = currentLoop;
+		}
+	}
+
+	// units that are not part of the observation anymore went into the fog, a bunker, a refinery or a transport
+	for (auto & kv : m_trackedUnits)
+	{
+		if (kv.second.lastUpdate != currentLoop && kv.second.visible)
+		{
+			kv.second.visible = false;
+			m_deltas.leftVision.push_back(kv.first);
+		}
+	}
+}
+
+const UnitDeltas & UnitInfoManager::getUnitDeltas() const
+{
+	return m_deltas;
+}
+
+// the attackers are looked up in the visible enemies sorted by x, so every event only looks at a small window
+void UnitInfoManager::updateDamageEvents()
+{
+	if (m_damageEvents.empty())
+	{
+		return;
+	}
+
+	m_enemiesByX.clear();
+	for (const auto & enemy : m_units[Players::Enemy])
+	{
+		if (enemy->display_type == sc2::Unit::DisplayType::Visible && enemy->is_alive)
+		{
+			m_enemiesByX.push_back(enemy);
+		}
+	}
+	std::sort(m_enemiesByX.begin(), m_enemiesByX.end(), [](const sc2::Unit * a, const sc2::Unit * b) { return a->pos.x < b->pos.x; });
+
+	for (auto & damage : m_damageEvents)
+	{
+		const sc2::Unit * unit = damage.unit;
+		auto it = std::lower_bound(m_enemiesByX.begin(), m_enemiesByX.end(), unit->pos.x - maxAttackerDistance, [](const sc2::Unit * a, float x) { return a->pos.x < x; });
+		for (; it != m_enemiesByX.end() && (*it)->pos.x <= unit->pos.x + maxAttackerDistance; ++it)
+		{
+			const sc2::Unit * enemy = *it;
+			// bunkers have no weapon of their own
+			const float range = enemy->unit_type == sc2::UNIT_TYPEID::TERRAN_BUNKER ? 7.0f : Util::GetAttackRange(enemy->unit_type, m_bot);
+			if (Util::Dist(enemy->pos, unit->pos) <= range + enemy->radius + unit->radius + 1.0f)
+			{
+				damage.attackers.push_back(enemy);
+			}
+		}
+	}
+}
+
+// a DT hits for 45 damage plus 5 per weapon upgrade
+void UnitInfoManager::detectDTs()
+{
+	if (m_bot.GetPlayerRace(Players::Enemy) != sc2::Race::Protoss)
+	{
+		return;
+	}
+	const float armor = static_cast<float>(m_infantryArmor);
+	for (const auto & damage : m_damageEvents)
+	{
+		const float lost = damage.healthLost + damage.shieldLost;
+		if (lost != 45.0f - armor && lost != 50.0f - armor && lost != 55.0f - armor && lost != 60.0f - armor)
+		{
+			continue;
+		}
+		// if we can already see it, there is nothing to scan
+		bool visibleDT = false;
+		for (const auto & attacker : damage.attackers)
+		{
+			if (attacker->unit_type == sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR)
+			{
+				visibleDT = true;
+				break;
+			}
+		}
+		if (!visibleDT)
+		{
+			m_bot.OnDTdetected(damage.unit->pos);
+		}
+	}
+}
+
+const std::vector<DamageEvent> & UnitInfoManager::getDamageEvents() const
+{
+	return m_damageEvents;
+}
+
+// the upgrade list only grows, so its size tells us if something finished
+void UnitInfoManager::updateUpgrades()
+{
+	const std::vector<sc2::UpgradeID> & upgrades = m_bot.Observation()->GetUpgrades();
+	if (upgrades.size() == m_numUpgrades)
+	{
+		return;
+	}
+	m_numUpgrades = upgrades.size();
+	m_upgrades.reset();
+	for (const auto & upgrade : upgrades)
+	{
+		if (static_cast<uint32_t>(upgrade) < m_upgrades.size())
+		{
+			m_upgrades.set(static_cast<uint32_t>(upgrade));
+		}
+	}
+
+	m_infantryWeapons = 0;
+	if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL3))
+	{
+		m_infantryWeapons = 3;
+	}
+	else if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL2))
+	{
+		m_infantryWeapons = 2;
+	}
+	else if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1))
+	{
+		m_infantryWeapons = 1;
+	}
+
+	m_infantryArmor = 0;
+	if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL3))
+	{
+		m_infantryArmor = 3;
+	}
+	else if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2))
+	{
+		m_infantryArmor = 2;
+	}
+	else if (hasUpgrade(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1))
+	{
+		m_infantryArmor = 1;
+	}
+}
+
+// research is only visible in the orders of the research buildings, which are just a handful
+void UnitInfoManager::updateResearch()
+{
+	static const sc2::UNIT_TYPEID researchBuildings[] = {
+		sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB,
+		sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB,
+		sc2::UNIT_TYPEID::TERRAN_STARPORTTECHLAB,
+		sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY,
+		sc2::UNIT_TYPEID::TERRAN_ARMORY,
+		sc2::UNIT_TYPEID::TERRAN_FUSIONCORE,
+		sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY
+	};
+
+	m_researching.reset();
+	m_infantryWeaponsResearching = false;
+	m_infantryArmorResearching = false;
+	for (const auto & type : researchBuildings)
+	{
+		for (const auto & unit : getUnits(Players::Self, type))
+		{
+			for (const auto & order : unit->orders)
+			{
+				// the generic abilities do not tell the level
+				if (order.ability_id == sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONS)
+				{
+					m_infantryWeaponsResearching = true;
+					continue;
+				}
+				if (order.ability_id == sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMOR)
+				{
+					m_infantryArmorResearching = true;
+					continue;
+				}
+				const uint32_t upgrade = static_cast<uint32_t>(Util::abilityIDToUpgradeID(order.ability_id.ToType()));
+				if (upgrade > 0 && upgrade < m_researching.size())
+				{
+					m_researching.set(upgrade);
+				}
+			}
+		}
+	}
+	m_infantryWeaponsResearching = m_infantryWeaponsResearching
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1)
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL2)
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL3);
+	m_infantryArmorResearching = m_infantryArmorResearching
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1)
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2)
+		|| isResearching(sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL3);
+}
+
+bool UnitInfoManager::hasUpgrade(sc2::UpgradeID upgrade) const
+{
+	const uint32_t id = static_cast<uint32_t>(upgrade);
+	return id < m_upgrades.size() && m_upgrades.test(id);
+}
+
+bool UnitInfoManager::isResearching(sc2::UpgradeID upgrade) const
+{
+	const uint32_t id = static_cast<uint32_t>(upgrade);
+	return id < m_researching.size() && m_researching.test(id);
+}
+
+int UnitInfoManager::getInfantryWeaponLevel(bool inProgress) const
+{
+	return m_infantryWeapons + (inProgress && m_infantryWeaponsResearching ? 1 : 0);
+}
+
+int UnitInfoManager::getInfantryArmorLevel(bool inProgress) const
+{
+	return m_infantryArmor + (inProgress && m_infantryArmorResearching ? 1 : 0);
+}
+
+const UnitInfoManager::UnitIndex & UnitInfoManager::getUnitIndex(int player) const
+{
+	BOT_ASSERT(m_unitIndex.find(player) != m_unitIndex.end(), "Couldn't find player unit index: %d", player);
+
+	return m_unitIndex.at(player);
+}
+
+UnitSpan UnitInfoManager::getUnits(int player, sc2::UnitTypeID type) const
+{
+	const UnitIndex & index = getUnitIndex(player);
+	const uint32_t id = type;
+	if (id >= index.typeRange.size())
+	{
+		return UnitSpan();
+	}
+	const auto & range = index.typeRange[id];
+	return UnitSpan(index.units.data() + range.first, index.units.data() + range.second);
+}
+
+// returns the units of the type together with its lowered/flying/burrowed/sieged variants
+UnitSpan UnitInfoManager::getUnitsWithAliases(int player, sc2::UnitTypeID type) const
+{
+	const UnitIndex & index = getUnitIndex(player);
+	const uint32_t id = Util::GetAliasType(type);
+	if (id >= index.aliasRange.size())
+	{
+		return UnitSpan();
+	}
+	const auto & range = index.aliasRange[id];
+	return UnitSpan(index.units.data() + range.first, index.units.data() + range.second);
+}
+
+UnitSpan UnitInfoManager::getUnitsByCategory(int player, int category) const
+{
+	BOT_ASSERT(category >= 0 && category < UnitCategory::NumCategories, "Invalid unit category: %d", category);
+	const std::vector<const sc2::Unit *> & units = getUnitIndex(player).categories[category];
+	return UnitSpan(units.data(), units.data() + units.size());
+}
+
 const int UnitInfoManager::getNumCombatUnits(int player) const
 {
 	BOT_ASSERT(m_units.find(player) != m_units.end(), "Couldn't find player units: %d", player);
@@ -231,7 +638,7 @@ void UnitInfoManager::drawSelectedUnitDebugInfo()
 
 		// Perform the pathing query.
 		{
-			float distance = query->PathingDistance(unit->pos, target);
+			float distance = m_bot.Pathing().getDistance(unit->pos, target);
 			target_info += "\nPathing dist: " + std::to_string(distance);
 		}
 
@@ -253,9 +660,21 @@ size_t UnitInfoManager::getUnitTypeCount(int player, sc2::UnitTypeID type, bool
 {
 	size_t count = 0;
 
-	for (auto & unit : getUnits(player))
+	if (!type)
+	{
+		for (auto & unit : getUnits(player))
+		{
+			if (!completed || unit->build_progress == 1.0f)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	for (auto & unit : getUnits(player, type))
 	{
-		if ((!type || type == unit->unit_type) && (!completed || unit->build_progress == 1.0f))
+		if (!completed || unit->build_progress == 1.0f)
 		{
 			count++;
 		}
@@ -294,6 +713,10 @@ void UnitInfoManager::drawUnitInformation(float x,float y) const
 	{
 		Drawing::drawSphere(m_bot,kv.second.lastPosition, 0.5f);
 		Drawing::drawText(m_bot, kv.second.lastPosition,sc2::UnitTypeToName(kv.second.type));
+		if (kv.second.uncertainty > 0.0f)
+		{
+			Drawing::drawSphere(m_bot, kv.second.predictedPosition, kv.second.uncertainty, sc2::Colors::Yellow);
+		}
 	}
 
 
@@ -315,7 +738,11 @@ void UnitInfoManager::updateUnit(const sc2::Unit * unit)
 	{
 		if (unit->is_alive)
 		{
-			m_unitData[Util::GetPlayer(unit)].updateUnit(unit);
+			const UnitInfo & ui = m_unitData[Util::GetPlayer(unit)].updateUnit(unit);
+			if (ui.player == Players::Self && (ui.healthLost > 0.0f || ui.shieldLost > 0.0f))
+			{
+				m_damageEvents.push_back(DamageEvent(unit, ui.healthLost, ui.shieldLost));
+			}
 		}
 		else
 		{
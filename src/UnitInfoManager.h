@@ -5,7 +5,71 @@
 #include "UnitData.h"
 #include "BaseLocation.h"
 
+#include <bitset>
+
 class CCBot;
+
+namespace UnitCategory
+{
+	enum { TownHall = 0, Production, Bunker, FlyingBuilding, NumCategories };
+}
+
+// read only view into one bucket of the unit index, valid until the next frame
+class UnitSpan
+{
+	const sc2::Unit * const * m_begin;
+	const sc2::Unit * const * m_end;
+
+public:
+
+	UnitSpan() : m_begin(nullptr), m_end(nullptr) {}
+	UnitSpan(const sc2::Unit * const * begin, const sc2::Unit * const * end) : m_begin(begin), m_end(end) {}
+
+	const sc2::Unit * const * begin() const { return m_begin; }
+	const sc2::Unit * const * end() const { return m_end; }
+	size_t size() const { return static_cast<size_t>(m_end - m_begin); }
+	bool empty() const { return m_begin == m_end; }
+	const sc2::Unit * front() const { return *m_begin; }
+	const sc2::Unit * operator[](size_t i) const { return m_begin[i]; }
+};
+
+// changes of the units since the last frame
+struct UnitDeltas
+{
+	sc2::Units created;			// our new units
+	sc2::Units destroyed;		// units of both players that died
+	sc2::Units enteredVision;	// enemies that became visible and our units leaving bunkers, refineries or transports
+	sc2::Units leftVision;		// the other way around
+	sc2::Units morphed;			// units that changed their type, e.g. lowered depots or sieged tanks
+	sc2::Units idle;			// our units that ran out of orders
+
+	void clear()
+	{
+		created.clear();
+		destroyed.clear();
+		enteredVision.clear();
+		leftVision.clear();
+		morphed.clear();
+		idle.clear();
+	}
+};
+
+// one of our units lost health or shields since the last frame
+struct DamageEvent
+{
+	const sc2::Unit *	unit;
+	float				healthLost;
+	float				shieldLost;
+	sc2::Units			attackers;	// visible enemies close enough to have done it, empty for cloaked attackers
+
+	DamageEvent(const sc2::Unit * unit, float healthLost, float shieldLost)
+		: unit(unit)
+		, healthLost(healthLost)
+		, shieldLost(shieldLost)
+	{
+	}
+};
+
 class UnitInfoManager 
 {
 	CCBot &		   m_bot;
@@ -14,8 +78,47 @@ class UnitInfoManager
 
 	std::map<int, std::vector<const sc2::Unit *>> m_units;
 
+	// units of one player sorted by alias and type, rebuilt every frame without reallocating
+	struct UnitIndex
+	{
+		std::vector<const sc2::Unit *>			  units;
+		std::vector<std::pair<size_t, size_t>>	  typeRange;
+		std::vector<std::pair<size_t, size_t>>	  aliasRange;
+		std::vector<const sc2::Unit *>			  categories[UnitCategory::NumCategories];
+	};
+	std::map<int, UnitIndex> m_unitIndex;
+
+	struct TrackedUnit
+	{
+		sc2::UnitTypeID type;
+		bool			visible;
+		uint32_t		lastUpdate;
+	};
+	std::unordered_map<const sc2::Unit *, TrackedUnit> m_trackedUnits;
+	UnitDeltas				m_deltas;
+	UnitDeltas				m_pendingDeltas;
+
+	std::vector<DamageEvent>		m_damageEvents;
+	std::vector<const sc2::Unit *>	m_enemiesByX;
+
+	// our upgrades, only rebuilt when the upgrade list of the observation changes
+	std::bitset<512>		m_upgrades;
+	std::bitset<512>		m_researching;
+	size_t					m_numUpgrades;
+	int						m_infantryWeapons;
+	int						m_infantryArmor;
+	bool					m_infantryWeaponsResearching;
+	bool					m_infantryArmorResearching;
+
 	void					updateUnit(const sc2::Unit * unit);
 	void					updateUnitInfo();
+	void					updateUnitIndex(int player);
+	void					updateUnitDeltas();
+	void					updateUpgrades();
+	void					updateResearch();
+	void					updateDamageEvents();
+	void					detectDTs();
+	const UnitIndex &		getUnitIndex(int player) const;
 	bool					isValidUnit(const sc2::Unit * unit);
 	
 	const UnitData &		getUnitData(int player) const;
@@ -28,8 +131,13 @@ public:
 
 	void					onFrame();
 	void					onStart();
+	void					onUnitDestroyed(const sc2::Unit * unit);
+	void					onUnitIdle(const sc2::Unit * unit);
 
 	const std::vector<const sc2::Unit *> & getUnits(int player) const;
+	UnitSpan				getUnits(int player, sc2::UnitTypeID type) const;
+	UnitSpan				getUnitsWithAliases(int player, sc2::UnitTypeID type) const;
+	UnitSpan				getUnitsByCategory(int player, int category) const;
 
 	const std::vector<const sc2::Unit*> getBuildings(int player) const;
 
@@ -38,6 +146,14 @@ public:
 	void					getNearbyForce(std::vector<UnitInfo> & unitInfo, sc2::Point2D p, int player, float radius) const;
 
 	const std::map<const sc2::Unit *, UnitInfo> & getUnitInfoMap(int player) const;
+	const UnitDeltas &		getUnitDeltas() const;
+	const std::vector<DamageEvent> & getDamageEvents() const;
+
+	bool					hasUpgrade(sc2::UpgradeID upgrade) const;
+	bool					isResearching(sc2::UpgradeID upgrade) const;
+	// finished levels, inProgress also counts the level that is currently researched
+	int						getInfantryWeaponLevel(bool inProgress = false) const;
+	int						getInfantryArmorLevel(bool inProgress = false) const;
 
 	//bool				  enemyHasCloakedUnits() const;
 	void					drawUnitInformation(float x, float y) const;
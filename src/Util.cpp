@@ -286,6 +286,43 @@ bool Util::IsBurrowedType(const sc2::UnitTypeID & type)
 	}
 }
 
+bool Util::IsProductionBuildingType(const sc2::UnitTypeID & type)
+{
+	switch (type.ToType())
+	{
+	case sc2::UNIT_TYPEID::TERRAN_BARRACKS: return true;
+	case sc2::UNIT_TYPEID::TERRAN_BARRACKSFLYING: return true;
+	case sc2::UNIT_TYPEID::TERRAN_FACTORY: return true;
+	case sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING: return true;
+	case sc2::UNIT_TYPEID::TERRAN_STARPORT: return true;
+	case sc2::UNIT_TYPEID::TERRAN_STARPORTFLYING: return true;
+	case sc2::UNIT_TYPEID::PROTOSS_GATEWAY: return true;
+	case sc2::UNIT_TYPEID::PROTOSS_WARPGATE: return true;
+	case sc2::UNIT_TYPEID::PROTOSS_ROBOTICSFACILITY: return true;
+	case sc2::UNIT_TYPEID::PROTOSS_STARGATE: return true;
+	default: return false;
+	}
+}
+
+// maps the lowered/flying/burrowed/sieged variant of a unit type to its base type
+sc2::UnitTypeID Util::GetAliasType(const sc2::UnitTypeID & type)
+{
+	switch (type.ToType())
+	{
+	case sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED: return sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT;
+	case sc2::UNIT_TYPEID::TERRAN_BARRACKSFLYING: return sc2::UNIT_TYPEID::TERRAN_BARRACKS;
+	case sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING: return sc2::UNIT_TYPEID::TERRAN_FACTORY;
+	case sc2::UNIT_TYPEID::TERRAN_STARPORTFLYING: return sc2::UNIT_TYPEID::TERRAN_STARPORT;
+	case sc2::UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING: return sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER;
+	case sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING: return sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND;
+	case sc2::UNIT_TYPEID::TERRAN_WIDOWMINEBURROWED: return sc2::UNIT_TYPEID::TERRAN_WIDOWMINE;
+	case sc2::UNIT_TYPEID::TERRAN_VIKINGASSAULT: return sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER;
+	case sc2::UNIT_TYPEID::TERRAN_SIEGETANKSIEGED: return sc2::UNIT_TYPEID::TERRAN_SIEGETANK;
+	case sc2::UNIT_TYPEID::TERRAN_LIBERATORAG: return sc2::UNIT_TYPEID::TERRAN_LIBERATOR;
+	default: return type;
+	}
+}
+
 int Util::GetPlayer(const sc2::Unit * unit)
 {
 	BOT_ASSERT(unit, "Unit pointer was null");
@@ -577,27 +614,8 @@ UnitTag GetClosestEnemyUnitTo(const sc2::Unit * ourUnit, const sc2::ObservationI
 bool Util::UnitCanBuildTypeNow(const sc2::Unit * unit, const sc2::UnitTypeID & type, CCBot & m_bot)
 {
 	BOT_ASSERT(unit, "Unit pointer was null");
-	sc2::AvailableAbilities available_abilities = m_bot.Query()->GetAbilitiesForUnit(unit);
-	
-	// quick check if the unit can't do anything it certainly can't build the thing we want
-	if (available_abilities.abilities.empty()) 
-	{
-		return false;
-	}
-	else 
-	{
-		// check to see if one of the unit's available abilities matches the build ability type
-		sc2::AbilityID buildTypeAbility = m_bot.Data(type).buildAbility;
-		for (const sc2::AvailableAbility & available_ability : available_abilities.abilities) 
-		{
-			if (available_ability.ability_id == buildTypeAbility)
-			{
-				return true;
-			}
-		}
-	}
-
-	return false;
+	// check to see if one of the unit's available abilities matches the build ability type
+	return m_bot.Abilities().canCast(unit, m_bot.Data(type).buildAbility);
 }
 
 bool Util::canHitMe(const sc2::Unit * me, const sc2::Unit * hitter, CCBot & bot)
@@ -729,6 +747,10 @@ const sc2::UpgradeID Util::abilityIDToUpgradeID(const sc2::ABILITY_ID id)
 	case sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL1: return sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1;
 	case sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL2: return sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2;
 	case sc2::ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL3: return sc2::UPGRADE_ID::TERRANINFANTRYARMORSLEVEL3;
+
+	case sc2::ABILITY_ID::RESEARCH_STIMPACK: return sc2::UPGRADE_ID::STIMPACK;
+	case sc2::ABILITY_ID::RESEARCH_COMBATSHIELD: return sc2::UPGRADE_ID::SHIELDWALL;
+	case sc2::ABILITY_ID::RESEARCH_CONCUSSIVESHELLS: return sc2::UPGRADE_ID::PUNISHERGRENADES;
 	}
 	return 0;
 }
@@ -28,6 +28,8 @@ namespace Util
 	bool IsDetector(const sc2::Unit * type);
 	bool IsDetectorType(const sc2::UnitTypeID & type);
 	bool IsBurrowedType(const sc2::UnitTypeID & type);
+	bool IsProductionBuildingType(const sc2::UnitTypeID & type);
+	sc2::UnitTypeID GetAliasType(const sc2::UnitTypeID & type);
 	bool IsGeyser(const sc2::Unit * unit);
 	bool IsMineral(const sc2::Unit * unit);
 	bool IsWorker(const sc2::Unit * unit);
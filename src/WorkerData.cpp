@@ -14,44 +14,38 @@ WorkerData::WorkerData(CCBot & bot)
 	}
 }
 
-void WorkerData::updateAllWorkerData()
+void WorkerData::updateAllWorkerData(const UnitDeltas & deltas)
 {
-	// check all our units and add new workers if we find them
-	for (const auto & unit : m_bot.UnitInfo().getUnits(Players::Self))
+	// add new workers and those that come back out of a refinery, bunker or transport
+	for (const auto & units : { &deltas.created, &deltas.enteredVision })
 	{
-		if (Util::IsWorker(unit))
+		for (const auto & unit : *units)
 		{
-			updateWorker(unit);
+			if (Util::GetPlayer(unit) == Players::Self && Util::IsWorker(unit) && m_workers.find(unit) == m_workers.end())
+			{
+				updateWorker(unit);
+				setWorkerJob(unit, WorkerJobs::Idle);
+			}
 		}
 	}
 
-	// for each of our Workers
-	for (const auto & worker : getWorkers())
+	// remove any worker units which no longer exist in the game
+	for (const auto & unit : deltas.destroyed)
 	{
-		// if it's idle
-		if (getWorkerJob(worker) == WorkerJobs::None)
+		if (m_workers.find(unit) != m_workers.end())
 		{
-			setWorkerJob(worker, WorkerJobs::Idle);
+			workerDestroyed(unit);
 		}
-
-		// TODO: If it's a gas worker whose refinery has been destroyed, set to minerals
 	}
 
-	// remove any worker units which no longer exist in the game
-	std::vector<const sc2::Unit *> workersDestroyed;
-	for (const auto & worker : getWorkers())
+	// TODO: for now skip gas workers because they disappear inside refineries, this is annoying
+	for (const auto & unit : deltas.leftVision)
 	{
-		// TODO: for now skip gas workers because they disappear inside refineries, this is annoying
-		if (!worker || !worker->is_alive || (m_bot.Observation()->GetGameLoop() != worker->last_seen_game_loop && getWorkerJob(worker) != WorkerJobs::Gas))
+		if (m_workers.find(unit) != m_workers.end() && getWorkerJob(unit) != WorkerJobs::Gas)
 		{
-			workersDestroyed.push_back(worker);
+			workerDestroyed(unit);
 		}
 	}
-
-	for (const auto & worker : workersDestroyed)
-	{
-		workerDestroyed(worker);
-	}
 }
 
 void WorkerData::workerDestroyed(const sc2::Unit * unit)
@@ -2,6 +2,7 @@
 #include "Common.h"
 
 class CCBot;
+struct UnitDeltas;
 
 namespace WorkerJobs
 {
@@ -29,7 +30,7 @@ public:
 	WorkerData(CCBot & bot);
 
 	void	workerDestroyed(const sc2::Unit * unit);
-	void	updateAllWorkerData();
+	void	updateAllWorkerData(const UnitDeltas & deltas);
 	void	updateWorker(const sc2::Unit * unit);
 	void	setWorkerJob(const sc2::Unit * unit, int job, const sc2::Unit * jobUnit = 0);
 	void	drawDepotDebugInfo();
@@ -16,9 +16,25 @@ void WorkerManager::onStart()
 
 }
 
+void WorkerManager::onUnitDeltas(const UnitDeltas & deltas)
+{
+	m_workerData.updateAllWorkerData(deltas);
+}
+
+// every step, the workers task itself might not run this step
+void WorkerManager::onDamageEvents(const std::vector<DamageEvent> & events)
+{
+	for (const auto & damage : events)
+	{
+		if (damage.unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BUNKER && damage.unit->build_progress == 1.0f)
+		{
+			m_damagedBunkers.insert(damage.unit);
+		}
+	}
+}
+
 void WorkerManager::onFrame()
 {
-	m_workerData.updateAllWorkerData();
 	handleGasWorkers();
 	handleMineralWorkers();
 	handleRepairWorkers();
@@ -113,7 +129,7 @@ void WorkerManager::handleGasWorkers()
 }
 void WorkerManager::handleMineralWorkers()
 {
-	const sc2::Units CommandCenters = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnits({ sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER , sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND , sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS }));
+	const UnitSpan CommandCenters = m_bot.UnitInfo().getUnitsByCategory(Players::Self, UnitCategory::TownHall);
 	// for each unit we have
 	for (const auto & unit : CommandCenters)
 	{
@@ -177,13 +193,21 @@ void WorkerManager::handleIdleWorkers()
 
 void WorkerManager::handleRepairWorkers()
 {
-	const sc2::Units Bunker = m_bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit( sc2::UNIT_TYPEID::TERRAN_BUNKER ));
-	for (const auto & b : Bunker)
+	// a bunker that got hit gets its repairers until it is healed
+	const int numBunkerRepairers = 6;
+	for (auto it = m_damagedBunkers.begin(); it != m_damagedBunkers.end();)
 	{
-		if (b->build_progress==1.0f && b->health < b->health_max)
+		const sc2::Unit * b = *it;
+		if (!b->is_alive || b->health >= b->health_max)
+		{
+			it = m_damagedBunkers.erase(it);
+			continue;
+		}
+		for (int i = static_cast<int>(isBeingRepairedNum(b)); i < numBunkerRepairers; ++i)
 		{
-			setRepairWorker(b,6);
+			setRepairWorker(b, numBunkerRepairers);
 		}
+		++it;
 	}
 	m_workerData.checkRepairedBuildings();
 }
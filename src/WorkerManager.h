@@ -4,6 +4,7 @@
 
 class Building;
 class CCBot;
+struct DamageEvent;
 
 class WorkerManager
 {
@@ -11,6 +12,7 @@ class WorkerManager
 
 	mutable WorkerData  m_workerData;
 	const sc2::Unit *   m_previousClosestWorker;
+	std::set<const sc2::Unit *> m_damagedBunkers;	// until they are healed
 
 	void		setMineralWorker(const sc2::Unit * unit);
 	
@@ -25,6 +27,8 @@ public:
 
 	void		onStart();
 	void		onFrame();
+	void		onUnitDeltas(const UnitDeltas & deltas);
+	void		onDamageEvents(const std::vector<DamageEvent> & events);
 
 	
 
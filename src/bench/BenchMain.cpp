@@ -0,0 +1,471 @@
+#include "CCBot.h"
+#include "AllocationTracker.h"
+#include "BuildingPlacer.h"
+#include "MockGame.h"
+#include "ReplayGame.h"
+#include "Timer.hpp"
+#include "Util.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+bool useDebug = false;
+bool useAutoObserver = false;
+
+namespace
+{
+	void writeActions(std::ostream & out, uint32_t gameLoop, const std::vector<RecordedAction> & actions)
+	{
+		for (const auto & action : actions)
+		{
+			out << gameLoop << " " << sc2::AbilityTypeToName(action.ability) << (action.queued ? " queued" : "");
+			if (action.target == RecordedAction::Target::Point)
+			{
+				out << " (" << action.point.x << ", " << action.point.y << ")";
+			}
+			else if (action.target == RecordedAction::Target::Unit)
+			{
+				out << " on " << action.targetTag;
+			}
+			for (const auto tag : action.units)
+			{
+				out << " " << tag;
+			}
+			out << "\n";
+		}
+	}
+
+	// counting the API calls slows down the bot, allocations a little
+	void startCounting(CCBot & bot, bool apiCalls, bool allocations)
+	{
+		if (apiCalls)
+		{
+			bot.ApiCalls().start(bot.Observation(), bot.Query());
+		}
+		AllocationTracker::setEnabled(allocations);
+	}
+
+	// steps the bot through a record of the ObservationRecorder and checks that it sends the recorded commands.
+	// The trace of traceStep goes to trace_<loop>.json, actions gets the commands as text to diff two builds.
+	int replay(const std::string & fileName, int traceStep, const std::string & actionsFile, bool apiCalls, bool allocations)
+	{
+		ReplayGame game;
+		if (!game.open(fileName))
+		{
+			std::cout << "Unable to read the record " << fileName << std::endl;
+			return 1;
+		}
+		std::ofstream actions;
+		if (!actionsFile.empty())
+		{
+			actions.open(actionsFile);
+		}
+
+		CCBot bot;
+		game.start(bot);
+		bot.Profiler().setEnabled(true);
+		startCounting(bot, apiCalls, allocations);
+
+		int steps = 0;
+		int differentSteps = 0;
+		uint32_t firstDifference = 0;
+		double slowestMs = 0.0;
+		uint32_t slowestLoop = 0;
+		Timer timer;
+		timer.start();
+		while (game.step(bot))
+		{
+			const bool trace = steps == traceStep;
+			bot.Profiler().setTracing(trace);
+			Timer stepTimer;
+			stepTimer.start();
+			bot.OnStep();
+			const double ms = stepTimer.getElapsedTimeInMilliSec();
+			if (ms > slowestMs)
+			{
+				slowestMs = ms;
+				slowestLoop = game.GetGameLoop();
+			}
+
+			const RecordedStep & recorded = game.getStep();
+			if (game.getActions() != recorded.actions)
+			{
+				if (differentSteps++ == 0)
+				{
+					firstDifference = recorded.gameLoop;
+				}
+			}
+			if (actions.is_open())
+			{
+				writeActions(actions, recorded.gameLoop, game.getActions());
+			}
+			game.SendActions();
+			game.stepAhead(bot);
+			if (trace)
+			{
+				bot.Profiler().setTracing(false);
+				bot.Profiler().writeTrace("trace_" + std::to_string(recorded.gameLoop) + ".json");
+				std::cout << "Step " << steps << " at game loop " << recorded.gameLoop << " took " << ms << " ms" << std::endl;
+			}
+			++steps;
+		}
+		const double ms = timer.getElapsedTimeInMilliSec();
+		bot.Profiler().onFrame();
+
+		std::cout << steps << " steps in " << ms << " ms, " << ms / std::max(1, steps) << " ms per step, the slowest at game loop " << slowestLoop << " took " << slowestMs << " ms" << std::endl;
+		if (differentSteps > 0)
+		{
+			std::cout << differentSteps << " steps sent other commands than recorded, the first at game loop " << firstDifference << std::endl;
+		}
+		else
+		{
+			std::cout << "All steps sent the recorded commands" << std::endl;
+		}
+		if (game.getMissingAnswers() > 0)
+		{
+			std::cout << game.getMissingAnswers() << " queries had no recorded answer" << std::endl;
+		}
+		bot.Profiler().writeTable(std::cout);
+		return differentSteps > 0 ? 2 : 0;
+	}
+
+	// replays a record with the allocations and API calls counted and compares the counts with the baseline, see
+	// ModuleProfiler::writeCounts. With write it writes the baseline instead.
+	int checkCounts(const std::string & fileName, const std::string & baselineFile, bool write)
+	{
+		ReplayGame game;
+		if (!game.open(fileName))
+		{
+			std::cout << "Unable to read the record " << fileName << std::endl;
+			return 1;
+		}
+
+		CCBot bot;
+		game.start(bot);
+		bot.Profiler().setEnabled(true);
+		startCounting(bot, true, true);
+		while (game.step(bot))
+		{
+			bot.OnStep();
+			game.SendActions();
+			game.stepAhead(bot);
+		}
+		bot.Profiler().onFrame();
+		AllocationTracker::setEnabled(false);
+
+		std::stringstream counts;
+		bot.Profiler().writeCounts(counts);
+		if (write)
+		{
+			std::ofstream out(baselineFile);
+			out << counts.str();
+			std::cout << (out ? "Wrote the counts to " : "Unable to write the counts to ") << baselineFile << std::endl;
+			return out ? 0 : 1;
+		}
+
+		std::ifstream in(baselineFile);
+		if (!in)
+		{
+			std::cout << "Unable to read the baseline " << baselineFile << std::endl;
+			return 1;
+		}
+		std::vector<std::string> expected;
+		std::vector<std::string> actual;
+		for (std::string line; std::getline(in, line);)
+		{
+			expected.push_back(line);
+		}
+		for (std::string line; std::getline(counts, line);)
+		{
+			actual.push_back(line);
+		}
+		// both are sorted
+		std::vector<std::string> missing;
+		std::vector<std::string> added;
+		std::set_difference(expected.begin(), expected.end(), actual.begin(), actual.end(), std::back_inserter(missing));
+		std::set_difference(actual.begin(), actual.end(), expected.begin(), expected.end(), std::back_inserter(added));
+		for (const auto & line : missing)
+		{
+			std::cout << "- " << line << std::endl;
+		}
+		for (const auto & line : added)
+		{
+			std::cout << "+ " << line << std::endl;
+		}
+		const size_t differences = missing.size() + added.size();
+		std::cout << (differences > 0 ? std::to_string(differences) + " counts differ from the baseline" : "The counts match the baseline") << std::endl;
+		return differences > 0 ? 4 : 0;
+	}
+
+	// the local rule that decides a placement, to tell the mismatches apart
+	enum class PlacementRule { Footprint, Creep, Resources, Addon, Num };
+	const char * const placementRuleNames[] = { "footprint", "creep", "town hall near resources", "addon" };
+
+	struct PlacementCount
+	{
+		size_t	agree = 0;
+		size_t	stricter = 0;		// the local rules say no, the game yes
+		size_t	looser = 0;			// the local rules say yes, the game no and nothing stood there
+		size_t	blockedByUnits = 0;	// the local rules say yes, the game no with units in the way or out of sight, the local rules do not know about those
+	};
+
+	// a ground unit stands in the footprint of size centered at (x, y) or the bot does not see all of it
+	bool unitInTheWay(const CCBot & bot, int x, int y, int size)
+	{
+		const float left = static_cast<float>(x - size / 2);
+		const float bottom = static_cast<float>(y - size / 2);
+		for (int tx = x - size / 2; tx < x - size / 2 + size; ++tx)
+		{
+			for (int ty = y - size / 2; ty < y - size / 2 + size; ++ty)
+			{
+				if (bot.Map().isValid(tx, ty) && bot.Observation()->GetVisibility(sc2::Point2D(tx + 0.5f, ty + 0.5f)) != sc2::Visibility::Visible)
+				{
+					return true;
+				}
+			}
+		}
+		for (const auto unit : bot.Observation()->GetUnits())
+		{
+			if (unit->is_flying || Util::IsBuildingType(unit->unit_type, bot) || Util::IsMineral(unit) || Util::IsGeyser(unit))
+			{
+				continue;
+			}
+			if (unit->pos.x + unit->radius > left && unit->pos.x - unit->radius < left + size
+				&& unit->pos.y + unit->radius > bottom && unit->pos.y - unit->radius < bottom + size)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// records the bot against MockGame as RecordObservations records a game. The map is small, so the record can be
+	// kept as a fixture of the tests.
+	int record(const std::string & fileName, int steps, int stepSize)
+	{
+		MockGame game(128, 128, 1);
+		CCBot bot;
+		bot.recordTo(fileName);
+		game.start(bot);
+		for (int i = 0; i < steps; ++i)
+		{
+			game.step(bot, bot.getStepSize(stepSize));
+			bot.OnStep();
+			bot.RawActions()->SendActions();
+		}
+		bot.OnGameEnd();
+		std::cout << "Recorded " << steps << " steps up to game loop " << game.GetGameLoop() << " to " << fileName << std::endl;
+		return 0;
+	}
+
+	// steps the bot through a record of the ObservationRecorder and compares BuildingPlacer::canPlaceLocally with every
+	// placement answer of the game in it. The recorder also asked for the addon of each production building.
+	int checkPlacement(const std::string & fileName)
+	{
+		ReplayGame game;
+		if (!game.open(fileName))
+		{
+			std::cout << "Unable to read the record " << fileName << std::endl;
+			return 1;
+		}
+
+		CCBot bot;
+		game.start(bot);
+		BuildingPlacer placer(bot);
+		placer.onStart();
+
+		std::map<sc2::AbilityID, sc2::UnitTypeID> buildTypes;
+		for (const auto & data : bot.Observation()->GetUnitTypeData())
+		{
+			if (data.race == sc2::Race::Terran && data.ability_id != sc2::ABILITY_ID::INVALID
+				&& std::find(data.attributes.begin(), data.attributes.end(), sc2::Attribute::Structure) != data.attributes.end())
+			{
+				buildTypes.emplace(data.ability_id, data.unit_type_id);
+			}
+		}
+		const int width = bot.Observation()->GetGameInfo().width;
+
+		PlacementCount counts[static_cast<int>(PlacementRule::Num)];
+		uint32_t firstMismatch = 0;
+		while (game.step(bot))
+		{
+			bot.OnStep();
+			game.SendActions();
+			game.stepAhead(bot);
+			placer.onUnitDeltas(bot.UnitInfo().getUnitDeltas());
+			placer.updatePlacementCache();
+
+			const RecordedStep & recorded = game.getStep();
+			std::set<std::pair<float, float>> addons;
+			for (const auto & answer : recorded.placement)
+			{
+				const sc2::AbilityID ability = answer.first.ability;
+				if (ability == sc2::ABILITY_ID::BUILD_BARRACKS || ability == sc2::ABILITY_ID::BUILD_FACTORY || ability == sc2::ABILITY_ID::BUILD_STARPORT)
+				{
+					const sc2::Point2D addon = getAddonPosition(answer.first.position);
+					addons.insert({ addon.x, addon.y });
+				}
+			}
+			for (const auto & answer : recorded.placement)
+			{
+				const auto it = buildTypes.find(answer.first.ability);
+				if (it == buildTypes.end() || Util::IsRefineryType(it->second))
+				{
+					continue;
+				}
+				const sc2::UnitTypeID type = it->second;
+				const int x = static_cast<int>(answer.first.position.x);
+				const int y = static_cast<int>(answer.first.position.y);
+				const int size = Util::GetUnitTypeWidth(type, bot);
+
+				PlacementRule rule = PlacementRule::Footprint;
+				if (type == sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT && addons.count({ answer.first.position.x, answer.first.position.y }) > 0)
+				{
+					rule = PlacementRule::Addon;
+				}
+				else
+				{
+					for (int tx = x - size / 2; tx < x - size / 2 + size; ++tx)
+					{
+						for (int ty = y - size / 2; ty < y - size / 2 + size; ++ty)
+						{
+							if (Util::IsTownHallType(type) && bot.Map().isNearResources(tx, ty))
+							{
+								rule = PlacementRule::Resources;
+							}
+							else if (rule == PlacementRule::Footprint && bot.Map().isValid(tx, ty) && recorded.creep[tx + ty * width] != 0)
+							{
+								rule = PlacementRule::Creep;
+							}
+						}
+					}
+				}
+
+				PlacementCount & count = counts[static_cast<int>(rule)];
+				const bool local = placer.canPlaceLocally(type, x, y, false);
+				if (local == answer.second)
+				{
+					++count.agree;
+					continue;
+				}
+				if (!local)
+				{
+					++count.stricter;
+				}
+				else if (unitInTheWay(bot, x, y, size))
+				{
+					++count.blockedByUnits;
+					continue;
+				}
+				else
+				{
+					++count.looser;
+				}
+				if (firstMismatch == 0)
+				{
+					firstMismatch = recorded.gameLoop;
+					std::cout << "First mismatch at game loop " << recorded.gameLoop << ": " << sc2::UnitTypeToName(type) << " at (" << x << ", " << y << ") is "
+						<< (answer.second ? "placeable" : "blocked") << " in the game, " << placementRuleNames[static_cast<int>(rule)] << std::endl;
+				}
+			}
+		}
+
+		size_t mismatches = 0;
+		std::cout << std::left << std::setw(28) << "Rule" << std::right << std::setw(10) << "agree" << std::setw(10) << "stricter" << std::setw(10) << "looser" << std::setw(10) << "units" << std::endl;
+		for (int rule = 0; rule < static_cast<int>(PlacementRule::Num); ++rule)
+		{
+			const PlacementCount & count = counts[rule];
+			std::cout << std::left << std::setw(28) << placementRuleNames[rule] << std::right << std::setw(10) << count.agree << std::setw(10) << count.stricter
+				<< std::setw(10) << count.looser << std::setw(10) << count.blockedByUnits << std::endl;
+			mismatches += count.stricter + count.looser;
+		}
+		std::cout << (mismatches > 0 ? std::to_string(mismatches) + " placements differ from the game" : "The local placement rules agree with the game") << std::endl;
+		return mismatches > 0 ? 3 : 0;
+	}
+}
+
+// runs the whole bot without the game and prints the time of every profiled zone.
+// Usage: 5minBench [steps=10000] [stepSize=1] [seed=1] [report]
+//   against MockGame. With report it also writes report.json and report.csv, as WriteProfile does after a game.
+// Usage: 5minBench replay <record> [traceStep=-1] [actions]
+//   against a record of RecordObservations, see replay above.
+// Both take --api-calls to list the busiest API call sites and --allocations for the allocations of every zone.
+// Usage: 5minBench record <record> [steps=200] [stepSize=8]
+//   records the bot against MockGame on a small map, see record above.
+// Usage: 5minBench placement <record>
+//   compares the local placement rules with the answers of the game in a record, see checkPlacement above.
+// Usage: 5minBench counts <record> <baseline> [write]
+//   compares the allocation and API call counts of a replay with the baseline, see checkCounts above.
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> args;
+	bool apiCalls = false;
+	bool allocations = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--api-calls")
+		{
+			apiCalls = true;
+		}
+		else if (arg == "--allocations")
+		{
+			allocations = true;
+		}
+		else
+		{
+			args.push_back(arg);
+		}
+	}
+
+	if (args.size() > 1 && args[0] == "replay")
+	{
+		return replay(args[1], args.size() > 2 ? std::stoi(args[2]) : -1, args.size() > 3 ? args[3] : "", apiCalls, allocations);
+	}
+	if (args.size() > 1 && args[0] == "record")
+	{
+		return record(args[1], args.size() > 2 ? std::stoi(args[2]) : 200, args.size() > 3 ? std::max(1, std::stoi(args[3])) : 8);
+	}
+	if (args.size() > 2 && args[0] == "counts")
+	{
+		return checkCounts(args[1], args[2], args.size() > 3 && args[3] == "write");
+	}
+	if (args.size() > 1 && args[0] == "placement")
+	{
+		return checkPlacement(args[1]);
+	}
+
+	const int steps = args.size() > 0 ? std::stoi(args[0]) : 10000;
+	const int stepSize = args.size() > 1 ? std::max(1, std::stoi(args[1])) : 1;
+	const unsigned seed = args.size() > 2 ? static_cast<unsigned>(std::stoul(args[2])) : 1;
+
+	MockGame game(160, 160, seed);
+	CCBot bot;
+	game.start(bot);
+	bot.Profiler().setEnabled(true);
+	startCounting(bot, apiCalls, allocations);
+
+	Timer timer;
+	timer.start();
+	for (int i = 0; i < steps; ++i)
+	{
+		game.step(bot, bot.getStepSize(stepSize));
+		bot.OnStep();
+		game.SendActions();
+	}
+	const double ms = timer.getElapsedTimeInMilliSec();
+	bot.Profiler().onFrame();
+
+	std::cout << steps << " steps up to game loop " << game.GetGameLoop() << " in " << ms << " ms, " << ms / std::max(1, steps) << " ms per step" << std::endl;
+	bot.Profiler().writeTable(std::cout);
+	if (args.size() > 3)
+	{
+		bot.Profiler().writeReport(args[3]);
+	}
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include "CCBot.h"
+#include "MockGame.h"
+#include "Util.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+bool useDebug = false;
+bool useAutoObserver = false;
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool ok, const std::string & what)
+	{
+		if (!ok)
+		{
+			std::cout << "  failed: " << what << std::endl;
+			++failures;
+		}
+	}
+
+	// the stand-in game with stim researched
+	class StimGame : public MockGame
+	{
+		std::vector<sc2::UpgradeID>	m_stim;
+
+	public:
+
+		StimGame() : m_stim({ sc2::UPGRADE_ID::STIMPACK }) {}
+
+		const std::vector<sc2::UpgradeID> & GetUpgrades() const override { return m_stim; }
+	};
+
+	sc2::Unit ownUnit(sc2::UNIT_TYPEID type, sc2::Tag tag, float health)
+	{
+		sc2::Unit unit;
+		unit.alliance = sc2::Unit::Alliance::Self;
+		unit.tag = tag;
+		unit.unit_type = type;
+		unit.build_progress = 1.0f;
+		unit.health = health;
+		unit.health_max = health;
+		unit.energy = 0.0f;
+		return unit;
+	}
+
+	// only marines and marauders stim, other units that kite must not wait for a stim that never comes
+	void checkStim()
+	{
+		StimGame game;
+		CCBot bot;
+		game.start(bot);
+		game.step(bot, 1);
+		bot.OnStep();
+
+		const sc2::Unit marine = ownUnit(sc2::UNIT_TYPEID::TERRAN_MARINE, 1000001, 45.0f);
+		const sc2::Unit marauder = ownUnit(sc2::UNIT_TYPEID::TERRAN_MARAUDER, 1000002, 125.0f);
+		check(bot.Abilities().isReady(&marine, sc2::ABILITY_ID::EFFECT_STIM), "a full marine stims");
+		check(bot.Abilities().isReady(&marauder, sc2::ABILITY_ID::EFFECT_STIM), "a full marauder stims");
+
+		for (const auto type : { sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER, sc2::UNIT_TYPEID::TERRAN_REAPER, sc2::UNIT_TYPEID::TERRAN_CYCLONE })
+		{
+			const sc2::Unit unit = ownUnit(type, 1000003, 135.0f);
+			const std::string name = sc2::UnitTypeToName(type);
+			check(!bot.Abilities().isReady(&unit, sc2::ABILITY_ID::EFFECT_STIM), "a full " + name + " does not stim");
+			check(bot.Abilities().loopsUntilReady(&unit, sc2::ABILITY_ID::EFFECT_STIM) == std::numeric_limits<uint32_t>::max(), "a " + name + " is never ready to stim");
+		}
+	}
+
+	// the more important command for a unit is the one the game gets, whichever manager gave its command first
+	void checkCommandPriority()
+	{
+		MockGame game;
+		CCBot bot;
+		game.start(bot);
+		game.step(bot, 1);
+		bot.OnStep();
+
+		const sc2::Units workers = bot.Observation()->GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_SCV));
+		check(!workers.empty(), "the game starts with workers");
+		if (workers.empty())
+		{
+			return;
+		}
+		const sc2::Unit * worker = workers.front();
+		for (const bool combatFirst : { true, false })
+		{
+			// new points each time, the order the worker already follows is not sent again
+			const float offset = combatFirst ? 5.0f : 8.0f;
+			const sc2::Point2D combat = sc2::Point2D(worker->pos) + sc2::Point2D(offset, 0.0f);
+			const sc2::Point2D economy = sc2::Point2D(worker->pos) + sc2::Point2D(0.0f, offset);
+			CommandBuffer & commands = *bot.Actions();
+			for (const bool giveCombat : { combatFirst, !combatFirst })
+			{
+				commands.setPriority(giveCombat ? CommandPriority::Combat : CommandPriority::Economy);
+				commands.UnitCommand(worker, sc2::ABILITY_ID::MOVE, giveCombat ? combat : economy);
+			}
+			commands.flush();
+			const std::string order = combatFirst ? "combat first" : "economy first";
+			check(commands.getSentThisFrame() == 1, "one of the two commands is sent, " + order);
+			check(worker->orders.size() == 1 && Util::Dist(worker->orders.front().target_pos, combat) < 0.5f, "the worker follows the combat command, " + order);
+		}
+	}
+
+	// micro running ahead asks for a fine step after OnStep, the request must survive until the step size is read
+	void checkFineStep()
+	{
+		MockGame game;
+		CCBot bot;
+		game.start(bot);
+		game.step(bot, 1);
+		bot.OnStep();
+		check(bot.getStepSize(8) == 8, "a step without a request advances the normal step size");
+		bot.OnStepAhead();
+		bot.requestFineStep();
+		game.step(bot, 8);
+		bot.OnStep();
+		check(bot.getStepSize(8) == 1, "a fine step asked for ahead advances one loop");
+		check(bot.getStepSize(8) == 8, "the next step advances the normal step size again");
+	}
+}
+
+// checks parts of the bot against the stand-in game, ctest runs it.
+// Usage: 5minChecks [name]
+//   runs all checks or the one with the name, fails if any check fails.
+int main(int argc, char* argv[])
+{
+	const std::vector<std::pair<std::string, std::function<void()>>> checks = {
+		{ "stim", checkStim },
+		{ "commandPriority", checkCommandPriority },
+		{ "fineStep", checkFineStep },
+	};
+
+	const std::string filter = argc > 1 ? argv[1] : "";
+	for (const auto & c : checks)
+	{
+		if (!filter.empty() && filter != c.first)
+		{
+			continue;
+		}
+		const int before = failures;
+		c.second();
+		std::cout << (failures == before ? "ok     " : "FAILED ") << c.first << std::endl;
+	}
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+#include "CCBot.h"
+#include "MockGame.h"
+#include "AllocationTracker.h"
+#include "BaseLocationManager.h"
+#include "BuildingPlacer.h"
+#include "DistanceMap.h"
+#include "JSONTools.h"
+#include "MapTools.h"
+#include "pathPlaning.h"
+#include "Timer.hpp"
+#include "Util.h"
+
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+bool useDebug = false;
+bool useAutoObserver = false;
+
+namespace
+{
+	struct Result
+	{
+		std::string	kernel;
+		size_t		iterations;
+		double		nsPerOp;
+		double		allocsPerOp;
+		double		bytesPerOp;
+		size_t		peakBytes;		// most heap in use during the runs, above what was in use before
+	};
+
+	struct Options
+	{
+		std::string	out = "microbench.json";
+		std::string	baseline;
+		std::string	filter;
+		double		minMs = 200.0;
+		double		tolerance = 0.15;
+	};
+
+	// runs op once to warm the caches, then as often as fits into minMs
+	Result measure(const std::string & kernel, const Options & options, const std::function<void()> & op)
+	{
+		op();
+
+		const size_t startAllocations = AllocationTracker::allocations();
+		const size_t startBytes = AllocationTracker::bytes();
+		const size_t startLive = AllocationTracker::liveBytes();
+		AllocationTracker::resetPeak();
+
+		Result result;
+		result.kernel = kernel;
+		result.iterations = 0;
+		Timer timer;
+		timer.start();
+		double us = 0.0;
+		do
+		{
+			op();
+			++result.iterations;
+			us = timer.getElapsedTimeInMicroSec();
+		} while (us < options.minMs * 1000.0 && result.iterations < 1000000);
+
+		const double n = static_cast<double>(result.iterations);
+		result.nsPerOp = us * 1000.0 / n;
+		const size_t peak = AllocationTracker::peakBytes();
+		result.allocsPerOp = (AllocationTracker::allocations() - startAllocations) / n;
+		result.bytesPerOp = (AllocationTracker::bytes() - startBytes) / n;
+		result.peakBytes = peak > startLive ? peak - startLive : 0;
+		return result;
+	}
+
+	std::string mapName(int size, float density)
+	{
+		std::stringstream ss;
+		ss << size << "/" << std::fixed << std::setprecision(2) << density;
+		return ss.str();
+	}
+
+	// the kernels on one synthetic map. The bot plays a few steps first, so there are occupied bases and the caches
+	// look like in a game.
+	void runMap(int size, float density, const Options & options, std::vector<Result> & results)
+	{
+		MockGame game(size, size, 1, density);
+		CCBot bot;
+		game.start(bot);
+		// OnGameStart set it from the config
+		AllocationTracker::setEnabled(true);
+		for (int i = 0; i < 50; ++i)
+		{
+			game.step(bot, bot.getStepSize(1));
+			bot.OnStep();
+			game.SendActions();
+		}
+
+		const std::string map = mapName(size, density);
+		const sc2::Point2D start(game.GetStartLocation());
+		const sc2::Point2D enemyStart(size - start.x, size - start.y);
+		const auto run = [&](const std::string & kernel, const std::function<void()> & op)
+		{
+			const std::string name = kernel + "/" + map;
+			if (name.find(options.filter) == std::string::npos)
+			{
+				return;
+			}
+			results.push_back(measure(name, options, op));
+			const Result & r = results.back();
+			std::cout << std::left << std::setw(40) << r.kernel << std::right << std::fixed << std::setprecision(0) << std::setw(12) << r.nsPerOp << " ns/op"
+				<< std::setprecision(1) << std::setw(10) << r.allocsPerOp << " allocs/op" << std::setprecision(0) << std::setw(12) << r.bytesPerOp << " B/op"
+				<< std::setw(12) << r.peakBytes << " B peak" << std::endl;
+		};
+
+		run("computeDistanceMap", [&]()
+		{
+			DistanceMap distanceMap;
+			distanceMap.computeDistanceMap(bot.Map().getWalkableGrid(), start);
+		});
+
+		MapTools mapTools(bot);
+		mapTools.onStart();
+		run("computeConnectivity", [&]()
+		{
+			mapTools.computeConnectivity();
+		});
+
+		run("planPath", [&]()
+		{
+			pathPlaning plan(bot, start, enemyStart, bot.Map().width(), bot.Map().height(), 1.0f);
+			plan.planPath();
+		});
+
+		// depots around the main, the placer keeps where it got to for each of them as it does in a game
+		BuildingPlacer placer(bot);
+		placer.onStart();
+		std::vector<sc2::Point2D> desired;
+		for (int i = 0; i < 16; ++i)
+		{
+			const float angle = i * 3.14159265f / 8.0f;
+			const float distance = 6.0f + (i % 3) * 3.0f;
+			desired.push_back(start + sc2::Point2D(std::cos(angle) * distance, std::sin(angle) * distance));
+		}
+		size_t next = 0;
+		run("getBuildLocationNear", [&]()
+		{
+			placer.getBuildLocationNear(Building(sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT, desired[next++ % desired.size()]), 0);
+		});
+
+		BaseLocationManager bases(bot);
+		bases.onStart();
+		run("computeTileBaseLocations", [&]()
+		{
+			bases.computeTileBaseLocations();
+		});
+
+		const sc2::Point2D worker = start + sc2::Point2D(-4.0f, 6.0f);
+		run("getClostestMineral", [&]()
+		{
+			Util::getClostestMineral(worker, bot);
+		});
+	}
+
+	bool writeResults(const std::string & fileName, const std::vector<Result> & results)
+	{
+		std::ofstream json(fileName);
+		if (!json)
+		{
+			return false;
+		}
+		json << "{\n\t\"kernels\": [";
+		bool first = true;
+		for (const auto & r : results)
+		{
+			json << (first ? "\n" : ",\n") << "\t\t{ \"kernel\": \"" << r.kernel << "\", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.nsPerOp
+				<< ", \"allocs_per_op\": " << r.allocsPerOp << ", \"bytes_per_op\": " << r.bytesPerOp << ", \"peak_bytes\": " << r.peakBytes << " }";
+			first = false;
+		}
+		json << "\n\t]\n}\n";
+		return true;
+	}
+
+	// a kernel regresses when it got slower than the tolerance allows or allocates more. The allocation count does not
+	// depend on the box, so it gets no tolerance beyond rounding.
+	int compareBaseline(const std::string & fileName, const std::vector<Result> & results, double tolerance)
+	{
+		const std::string text = JSONTools::ReadFile(fileName);
+		rapidjson::Document doc;
+		if (text.empty() || doc.Parse(text.c_str()).HasParseError() || !doc.HasMember("kernels") || !doc["kernels"].IsArray())
+		{
+			std::cout << "Unable to read the baseline " << fileName << std::endl;
+			return 1;
+		}
+
+		const rapidjson::Value & kernels = doc["kernels"];
+		int regressions = 0;
+		for (const auto & r : results)
+		{
+			for (rapidjson::SizeType k(0); k < kernels.Size(); ++k)
+			{
+				const rapidjson::Value & base = kernels[k];
+				if (!base.HasMember("kernel") || !base["kernel"].IsString() || r.kernel != base["kernel"].GetString())
+				{
+					continue;
+				}
+				const double baseNs = base["ns_per_op"].GetDouble();
+				const double baseAllocs = base["allocs_per_op"].GetDouble();
+				if (r.nsPerOp > baseNs * (1.0 + tolerance))
+				{
+					std::cout << "Regression: " << r.kernel << " takes " << r.nsPerOp << " ns/op, the baseline " << baseNs << std::endl;
+					++regressions;
+				}
+				if (r.allocsPerOp > baseAllocs + 0.5)
+				{
+					std::cout << "Regression: " << r.kernel << " allocates " << r.allocsPerOp << " times per op, the baseline " << baseAllocs << std::endl;
+					++regressions;
+				}
+			}
+		}
+		std::cout << (regressions > 0 ? std::to_string(regressions) + " regressions" : "No regressions") << " against " << fileName << std::endl;
+		return regressions > 0 ? 1 : 0;
+	}
+}
+
+// times the map and placement kernels on synthetic maps of several sizes and rock densities.
+// Usage: 5minMicroBench [--out microbench.json] [--baseline file] [--filter text] [--min-ms 200] [--tolerance 0.15]
+//   writes the results to out. With a baseline, the results of an earlier run on the same box, it fails on regressions.
+int main(int argc, char* argv[])
+{
+	Options options;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--out") { options.out = argv[i + 1]; }
+		else if (option == "--baseline") { options.baseline = argv[i + 1]; }
+		else if (option == "--filter") { options.filter = argv[i + 1]; }
+		else if (option == "--min-ms") { options.minMs = std::stod(argv[i + 1]); }
+		else if (option == "--tolerance") { options.tolerance = std::stod(argv[i + 1]); }
+		else
+		{
+			std::cout << "Unknown option " << option << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+	for (const int size : { 160, 200, 240 })
+	{
+		for (const float density : { 0.0f, 0.1f, 0.25f })
+		{
+			runMap(size, density, options, results);
+		}
+	}
+
+	if (!writeResults(options.out, results))
+	{
+		std::cout << "Unable to write the results to " << options.out << std::endl;
+		return 1;
+	}
+	return options.baseline.empty() ? 0 : compareBaseline(options.baseline, results, options.tolerance);
+}
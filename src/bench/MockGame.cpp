@@ -0,0 +1,1196 @@
+#include "MockGame.h"
+#include "CCBot.h"
+#include "Util.h"
+#include <algorithm>
+#include <cmath>
+
+// the real data tables are indexed by id, these are larger than any id in use
+const size_t unitTypeCount = 2048;
+const size_t abilityCount = 5000;
+const size_t upgradeCount = 512;
+const size_t buffCount = 512;
+const size_t effectCount = 16;
+
+const float loopsPerSecond = 22.4f;
+// movement speeds are given per normal speed second, the game runs on faster
+const float loopsPerDistance = 16.0f;
+const float groundHeight = 10.0f;
+const uint32_t waveInterval = 1344;
+const uint32_t stormDuration = 64;
+const float mineralsPerLoop = 1.0f / 16.0f;
+const float gasPerLoop = 1.0f / 20.0f;
+
+namespace
+{
+	bool inRect(int x, int y, int width, int height, float x0, float x1, float y0, float y1)
+	{
+		return x >= x0 * width && x < x1 * width && y >= y0 * height && y < y1 * height;
+	}
+
+	sc2::Point2D rotate(const sc2::Point2D & v, float angle)
+	{
+		return sc2::Point2D(v.x * std::cos(angle) - v.y * std::sin(angle), v.x * std::sin(angle) + v.y * std::cos(angle));
+	}
+
+	// the game snaps structures to the grid, odd footprints to the center of a tile and even ones to its corner
+	sc2::Point2D snapToGrid(const sc2::Point2D & pos, float footprint)
+	{
+		if (static_cast<int>(2.0f * footprint) % 2 == 1)
+		{
+			return sc2::Point2D(std::floor(pos.x) + 0.5f, std::floor(pos.y) + 0.5f);
+		}
+		return sc2::Point2D(std::round(pos.x), std::round(pos.y));
+	}
+
+	bool isTownHall(sc2::UnitTypeID type)
+	{
+		return type == sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER || type == sc2::UNIT_TYPEID::PROTOSS_NEXUS || type == sc2::UNIT_TYPEID::ZERG_HATCHERY;
+	}
+
+	bool isMineral(sc2::UnitTypeID type)
+	{
+		return type == sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD || type == sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD750;
+	}
+
+	bool isGasBuilding(sc2::UnitTypeID type)
+	{
+		return type == sc2::UNIT_TYPEID::TERRAN_REFINERY || type == sc2::UNIT_TYPEID::PROTOSS_ASSIMILATOR;
+	}
+
+	// returns true once the unit is there
+	bool moveTowards(sc2::Unit & unit, const sc2::Point2D & goal, float speed, uint32_t loops)
+	{
+		const float step = speed * loops / loopsPerDistance;
+		const float dist = sc2::Distance2D(unit.pos, goal);
+		if (dist <= step || dist < 0.01f)
+		{
+			unit.pos = sc2::Point3D(goal.x, goal.y, unit.pos.z);
+			return true;
+		}
+		const sc2::Point2D delta = (goal - unit.pos) * (step / dist);
+		unit.pos = sc2::Point3D(unit.pos.x + delta.x, unit.pos.y + delta.y, unit.pos.z);
+		return false;
+	}
+}
+
+MockGame::MockGame(int width, int height, unsigned seed, float obstacleDensity)
+	: m_width(width)
+	, m_height(height)
+	, m_gameLoop(0)
+	, m_nextTag(1)
+	, m_random(seed)
+	, m_startLocation(30.5f, 30.5f)
+	, m_enemyStartLocation(width - 30.5f, height - 30.5f)
+	, m_bases({ m_startLocation, sc2::Point2D(30.5f, std::floor(0.44f * height) + 0.5f), sc2::Point2D(std::floor(0.44f * width) + 0.5f, 30.5f),
+		sc2::Point2D(std::floor(0.39f * width) + 0.5f, std::floor(0.39f * height) + 0.5f) })
+	, m_effectsUntil(0)
+	, m_minerals(50.0f)
+	, m_vespene(0.0f)
+{
+	createTypeData();
+	createMap(obstacleDensity);
+
+	for (size_t i = 0; i < m_bases.size(); ++i)
+	{
+		const sc2::Point2D mirrored(width - m_bases[i].x, height - m_bases[i].y);
+		createBase(m_bases[i], i == 0 ? sc2::Unit::Alliance::Self : sc2::Unit::Alliance::Neutral);
+		createBase(mirrored, i == 0 ? sc2::Unit::Alliance::Enemy : sc2::Unit::Alliance::Neutral);
+	}
+	createArmy(m_startLocation + sc2::Point2D(12.0f, 12.0f));
+	m_created.clear();
+	updateVisibility();
+}
+
+void MockGame::addSpec(const TypeSpec & spec, const std::vector<sc2::ABILITY_ID> & abilities)
+{
+	m_specs[spec.type] = spec;
+	m_unitAbilities[spec.type] = abilities;
+	if (spec.ability != sc2::ABILITY_ID::INVALID)
+	{
+		m_produces[spec.ability] = spec.type;
+		m_abilities[static_cast<size_t>(spec.ability)].footprint_radius = spec.footprint;
+		m_abilities[static_cast<size_t>(spec.ability)].is_building = spec.footprint > 0.0f;
+	}
+
+	sc2::UnitTypeData & data = m_unitTypes[static_cast<size_t>(spec.type)];
+	data.mineral_cost = spec.minerals;
+	data.vespene_cost = spec.gas;
+	data.food_required = spec.food;
+	data.food_provided = spec.foodProvided;
+	data.ability_id = spec.ability;
+	data.race = spec.race;
+	data.movement_speed = spec.speed;
+	data.sight_range = spec.footprint > 0.0f ? 11.0f : 9.0f;
+	data.attributes = spec.footprint > 0.0f ? std::vector<sc2::Attribute>{ sc2::Attribute::Structure, sc2::Attribute::Armored } : std::vector<sc2::Attribute>{ sc2::Attribute::Biological };
+	if (spec.range > 0.0f)
+	{
+		sc2::Weapon weapon;
+		weapon.type = spec.flying ? sc2::Weapon::TargetType::Any : sc2::Weapon::TargetType::Ground;
+		weapon.damage_ = spec.damage;
+		weapon.attacks = 1;
+		weapon.range = spec.range;
+		weapon.speed = spec.cooldown;
+		data.weapons.push_back(weapon);
+	}
+}
+
+void MockGame::createTypeData()
+{
+	m_unitTypes.resize(unitTypeCount);
+	for (size_t i = 0; i < unitTypeCount; ++i)
+	{
+		sc2::UnitTypeData & data = m_unitTypes[i];
+		data.unit_type_id = sc2::UnitTypeID(static_cast<uint32_t>(i));
+		data.name = sc2::UnitTypeToName(data.unit_type_id);
+		data.available = true;
+		data.cargo_size = 1;
+		data.mineral_cost = 0;
+		data.vespene_cost = 0;
+		data.movement_speed = 0.0f;
+		data.armor = 0.0f;
+		data.food_required = 0.0f;
+		data.food_provided = 0.0f;
+		data.ability_id = sc2::ABILITY_ID::INVALID;
+		data.race = sc2::Race::Random;
+		data.build_time = 400.0f;
+		data.has_vespene = false;
+		data.has_minerals = false;
+		data.sight_range = 9.0f;
+		data.unit_alias = sc2::UnitTypeID(0u);
+		data.tech_requirement = sc2::UnitTypeID(0u);
+		data.require_attached = false;
+	}
+	m_abilities.resize(abilityCount);
+	for (size_t i = 0; i < abilityCount; ++i)
+	{
+		sc2::AbilityData & data = m_abilities[i];
+		data.available = true;
+		data.ability_id = sc2::AbilityID(static_cast<uint32_t>(i));
+		data.link_index = 0;
+		data.remaps_to_ability_id = 0;
+		data.target = sc2::AbilityData::Target::None;
+		data.allow_minimap = false;
+		data.allow_autocast = false;
+		data.is_building = false;
+		data.footprint_radius = 0.0f;
+		data.is_instant_placement = false;
+		data.cast_range = 0.0f;
+	}
+	m_upgrades.resize(upgradeCount);
+	for (size_t i = 0; i < upgradeCount; ++i)
+	{
+		m_upgrades[i].upgrade_id = sc2::UpgradeID(static_cast<uint32_t>(i));
+		m_upgrades[i].name = sc2::UpgradeIDToName(m_upgrades[i].upgrade_id);
+		m_upgrades[i].mineral_cost = 100;
+		m_upgrades[i].vespene_cost = 100;
+		m_upgrades[i].ability_id = sc2::ABILITY_ID::INVALID;
+		m_upgrades[i].research_time = 1000.0f;
+	}
+	m_buffs.resize(buffCount);
+	for (size_t i = 0; i < buffCount; ++i)
+	{
+		m_buffs[i].buff_id = sc2::BuffID(static_cast<uint32_t>(i));
+		m_buffs[i].name = sc2::BuffIDToName(m_buffs[i].buff_id);
+	}
+	m_effectData.resize(effectCount);
+	for (size_t i = 0; i < effectCount; ++i)
+	{
+		m_effectData[i].effect_id = static_cast<uint32_t>(i);
+		m_effectData[i].radius = 1.5f;
+	}
+
+	using namespace sc2;
+	//		type								race			min  gas food prov	ability								fp	   radius health speed range dmg cooldown flying
+	addSpec({ UNIT_TYPEID::TERRAN_COMMANDCENTER,	Race::Terran,	400,   0, 0, 15, ABILITY_ID::BUILD_COMMANDCENTER,	2.5f, 2.75f, 1500, 0.0f, 0.0f, 0, 0.0f, false }, { ABILITY_ID::TRAIN_SCV, ABILITY_ID::EFFECT_CALLDOWNMULE });
+	addSpec({ UNIT_TYPEID::TERRAN_SUPPLYDEPOT,		Race::Terran,	100,   0, 0,  8, ABILITY_ID::BUILD_SUPPLYDEPOT,		1.0f, 1.0f,  400,  0.0f, 0.0f, 0, 0.0f, false }, { ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER });
+	addSpec({ UNIT_TYPEID::TERRAN_BARRACKS,			Race::Terran,	150,   0, 0,  0, ABILITY_ID::BUILD_BARRACKS,		1.5f, 1.8f,  1000, 0.0f, 0.0f, 0, 0.0f, false }, { ABILITY_ID::TRAIN_MARINE, ABILITY_ID::TRAIN_MARAUDER });
+	addSpec({ UNIT_TYPEID::TERRAN_FACTORY,			Race::Terran,	150, 100, 0,  0, ABILITY_ID::BUILD_FACTORY,			1.5f, 1.8f,  1250, 0.0f, 0.0f, 0, 0.0f, false }, { ABILITY_ID::TRAIN_SIEGETANK, ABILITY_ID::TRAIN_WIDOWMINE });
+	addSpec({ UNIT_TYPEID::TERRAN_STARPORT,			Race::Terran,	150, 100, 0,  0, ABILITY_ID::BUILD_STARPORT,		1.5f, 1.8f,  1300, 0.0f, 0.0f, 0, 0.0f, false }, { ABILITY_ID::TRAIN_MEDIVAC, ABILITY_ID::TRAIN_VIKINGFIGHTER });
+	addSpec({ UNIT_TYPEID::TERRAN_REFINERY,			Race::Terran,	 75,   0, 0,  0, ABILITY_ID::BUILD_REFINERY,		1.5f, 1.8f,  500,  0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::TERRAN_ENGINEERINGBAY,	Race::Terran,	125,   0, 0,  0, ABILITY_ID::BUILD_ENGINEERINGBAY,	1.5f, 1.8f,  850,  0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::TERRAN_BUNKER,			Race::Terran,	100,   0, 0,  0, ABILITY_ID::BUILD_BUNKER,			1.5f, 1.8f,  400,  0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::TERRAN_MISSILETURRET,	Race::Terran,	100,   0, 0,  0, ABILITY_ID::BUILD_MISSILETURRET,	1.0f, 1.0f,  250,  0.0f, 7.0f, 12, 0.86f, true });
+	addSpec({ UNIT_TYPEID::TERRAN_SCV,				Race::Terran,	 50,   0, 1,  0, ABILITY_ID::TRAIN_SCV,				0.0f, 0.375f, 45,  2.8f, 0.1f, 5, 1.07f, false });
+	addSpec({ UNIT_TYPEID::TERRAN_MARINE,			Race::Terran,	 50,   0, 1,  0, ABILITY_ID::TRAIN_MARINE,			0.0f, 0.375f, 45,  2.25f, 5.0f, 6, 0.61f, true }, { ABILITY_ID::EFFECT_STIM });
+	addSpec({ UNIT_TYPEID::TERRAN_MARAUDER,			Race::Terran,	100,  25, 2,  0, ABILITY_ID::TRAIN_MARAUDER,		0.0f, 0.5625f, 125, 2.25f, 6.0f, 10, 1.07f, false }, { ABILITY_ID::EFFECT_STIM });
+	addSpec({ UNIT_TYPEID::TERRAN_SIEGETANK,		Race::Terran,	150, 125, 3,  0, ABILITY_ID::TRAIN_SIEGETANK,		0.0f, 0.875f, 175, 2.25f, 7.0f, 15, 0.74f, false }, { ABILITY_ID::MORPH_SIEGEMODE });
+	addSpec({ UNIT_TYPEID::TERRAN_WIDOWMINE,		Race::Terran,	 75,  25, 2,  0, ABILITY_ID::TRAIN_WIDOWMINE,		0.0f, 0.5f,   90,  2.8f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::TERRAN_MEDIVAC,			Race::Terran,	100, 100, 2,  0, ABILITY_ID::TRAIN_MEDIVAC,			0.0f, 0.75f, 150,  3.5f, 0.0f, 0, 0.0f, true });
+	addSpec({ UNIT_TYPEID::TERRAN_VIKINGFIGHTER,	Race::Terran,	150,  75, 2,  0, ABILITY_ID::TRAIN_VIKINGFIGHTER,	0.0f, 0.75f, 135,  3.85f, 9.0f, 10, 1.43f, true });
+	addSpec({ UNIT_TYPEID::PROTOSS_NEXUS,			Race::Protoss,	400,   0, 0, 15, ABILITY_ID::BUILD_NEXUS,			2.5f, 2.75f, 2000, 0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::PROTOSS_PROBE,			Race::Protoss,	 50,   0, 1,  0, ABILITY_ID::TRAIN_PROBE,			0.0f, 0.375f, 40,  2.8f, 0.1f, 5, 1.07f, false });
+	addSpec({ UNIT_TYPEID::PROTOSS_ZEALOT,			Race::Protoss,	100,   0, 2,  0, ABILITY_ID::TRAIN_ZEALOT,			0.0f, 0.5f,  150,  2.25f, 0.1f, 16, 0.86f, false });
+	addSpec({ UNIT_TYPEID::PROTOSS_STALKER,			Race::Protoss,	125,  50, 2,  0, ABILITY_ID::TRAIN_STALKER,			0.0f, 0.625f, 160, 2.95f, 6.0f, 13, 1.34f, true });
+	addSpec({ UNIT_TYPEID::PROTOSS_ASSIMILATOR,		Race::Protoss,	 75,   0, 0,  0, ABILITY_ID::BUILD_ASSIMILATOR,		1.5f, 1.8f,  450,  0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::NEUTRAL_MINERALFIELD,	Race::Random,	  0,   0, 0,  0, ABILITY_ID::INVALID,				0.0f, 1.125f, 1,   0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::NEUTRAL_MINERALFIELD750,	Race::Random,	  0,   0, 0,  0, ABILITY_ID::INVALID,				0.0f, 1.125f, 1,   0.0f, 0.0f, 0, 0.0f, false });
+	addSpec({ UNIT_TYPEID::NEUTRAL_VESPENEGEYSER,	Race::Random,	  0,   0, 0,  0, ABILITY_ID::INVALID,				0.0f, 2.125f, 1,   0.0f, 0.0f, 0, 0.0f, false });
+	m_unitTypes[static_cast<size_t>(UNIT_TYPEID::NEUTRAL_MINERALFIELD)].has_minerals = true;
+	m_unitTypes[static_cast<size_t>(UNIT_TYPEID::NEUTRAL_MINERALFIELD750)].has_minerals = true;
+	m_unitTypes[static_cast<size_t>(UNIT_TYPEID::NEUTRAL_VESPENEGEYSER)].has_vespene = true;
+}
+
+void MockGame::createMap(float obstacleDensity)
+{
+	m_gameInfo.width = m_width;
+	m_gameInfo.height = m_height;
+	m_gameInfo.playable_min = sc2::Point2D(8.0f, 8.0f);
+	m_gameInfo.playable_max = sc2::Point2D(m_width - 8.0f, m_height - 8.0f);
+	m_gameInfo.map_name = "MockGame";
+	m_gameInfo.start_locations = { m_enemyStartLocation };
+	m_gameInfo.enemy_start_locations = { m_enemyStartLocation };
+	m_gameInfo.player_info.push_back(sc2::PlayerInfo(1, sc2::PlayerType::Participant, sc2::Race::Terran, sc2::Race::Terran));
+	m_gameInfo.player_info.push_back(sc2::PlayerInfo(2, sc2::PlayerType::Computer, sc2::Race::Protoss, sc2::Race::Protoss));
+
+	for (sc2::ImageData * grid : { &m_gameInfo.pathing_grid, &m_gameInfo.placement_grid, &m_gameInfo.terrain_height })
+	{
+		grid->width = m_width;
+		grid->height = m_height;
+		grid->bits_per_pixel = 8;
+		grid->data.assign(m_width * m_height, 0);
+	}
+	const char height = static_cast<char>(static_cast<unsigned char>((groundHeight + 100.0f) / 200.0f * 255.0f));
+	for (int x = 0; x < m_width; ++x)
+	{
+		for (int y = 0; y < m_height; ++y)
+		{
+			// four cliffs around the middle, so paths are not all straight
+			const bool cliff = inRect(x, y, m_width, m_height, 0.45f, 0.55f, 0.25f, 0.32f) || inRect(x, y, m_width, m_height, 0.45f, 0.55f, 0.68f, 0.75f)
+				|| inRect(x, y, m_width, m_height, 0.25f, 0.32f, 0.45f, 0.55f) || inRect(x, y, m_width, m_height, 0.68f, 0.75f, 0.45f, 0.55f);
+			const bool playable = x >= m_gameInfo.playable_min.x && x < m_gameInfo.playable_max.x && y >= m_gameInfo.playable_min.y && y < m_gameInfo.playable_max.y;
+			const size_t i = x + (m_height - 1 - y) * m_width;
+			m_gameInfo.pathing_grid.data[i] = playable && !cliff ? 0 : static_cast<char>(255);
+			m_gameInfo.placement_grid.data[i] = playable && !cliff ? static_cast<char>(255) : 0;
+			m_gameInfo.terrain_height.data[i] = height;
+		}
+	}
+	if (obstacleDensity > 0.0f)
+	{
+		addRocks(obstacleDensity);
+	}
+	m_visibility.assign(m_width * m_height, 0);
+
+	// as if the enemy was zerg and spread creep from two of its bases
+	m_creep.assign(m_width * m_height, 0);
+	for (const auto & base : { m_bases[1], m_bases[2] })
+	{
+		const sc2::Point2D center(m_width - base.x, m_height - base.y);
+		for (int x = 0; x < m_width; ++x)
+		{
+			for (int y = 0; y < m_height; ++y)
+			{
+				if (sc2::Distance2D(center, sc2::Point2D(x + 0.5f, y + 0.5f)) < 10.0f)
+				{
+					m_creep[x * m_height + y] = 1;
+				}
+			}
+		}
+	}
+}
+
+// square rocks of 3 to 6 tiles until they cover obstacleDensity of the playable area. They may close off pockets of the
+// map, the bases and the ground around them stay free.
+void MockGame::addRocks(float obstacleDensity)
+{
+	const int minX = static_cast<int>(m_gameInfo.playable_min.x);
+	const int minY = static_cast<int>(m_gameInfo.playable_min.y);
+	const int maxX = static_cast<int>(m_gameInfo.playable_max.x);
+	const int maxY = static_cast<int>(m_gameInfo.playable_max.y);
+	std::uniform_int_distribution<int> size(3, 6);
+	std::uniform_int_distribution<int> randomX(minX, maxX - 1);
+	std::uniform_int_distribution<int> randomY(minY, maxY - 1);
+
+	std::vector<sc2::Point2D> keepFree;
+	for (const auto & base : m_bases)
+	{
+		keepFree.push_back(base);
+		keepFree.push_back(sc2::Point2D(m_width - base.x, m_height - base.y));
+	}
+
+	const int wanted = static_cast<int>(obstacleDensity * (maxX - minX) * (maxY - minY));
+	int covered = 0;
+	for (int tries = 0; covered < wanted && tries < 100000; ++tries)
+	{
+		const int side = size(m_random);
+		const int x0 = randomX(m_random);
+		const int y0 = randomY(m_random);
+		const sc2::Point2D center(x0 + side / 2.0f, y0 + side / 2.0f);
+		if (std::any_of(keepFree.begin(), keepFree.end(), [&center](const sc2::Point2D & base) { return sc2::Distance2D(base, center) < 16.0f; }))
+		{
+			continue;
+		}
+		for (int x = x0; x < std::min(x0 + side, maxX); ++x)
+		{
+			for (int y = y0; y < std::min(y0 + side, maxY); ++y)
+			{
+				const size_t i = x + (m_height - 1 - y) * m_width;
+				if (m_gameInfo.pathing_grid.data[i] == 0)
+				{
+					m_gameInfo.pathing_grid.data[i] = static_cast<char>(255);
+					m_gameInfo.placement_grid.data[i] = 0;
+					++covered;
+				}
+			}
+		}
+	}
+}
+
+sc2::Unit & MockGame::addUnit(sc2::UNIT_TYPEID type, sc2::Unit::Alliance alliance, const sc2::Point2D & pos)
+{
+	const auto spec = m_specs.find(type);
+	BOT_ASSERT(spec != m_specs.end(), "MockGame has no data for %s", sc2::UnitTypeToName(type));
+	m_units.emplace_back();
+	sc2::Unit & unit = m_units.back();
+	unit.display_type = alliance == sc2::Unit::Alliance::Neutral ? sc2::Unit::DisplayType::Snapshot : sc2::Unit::DisplayType::Visible;
+	unit.alliance = alliance;
+	unit.tag = m_nextTag++;
+	unit.unit_type = type;
+	unit.owner = alliance == sc2::Unit::Alliance::Self ? 1 : alliance == sc2::Unit::Alliance::Enemy ? 2 : 16;
+	unit.pos = sc2::Point3D(pos.x, pos.y, groundHeight);
+	unit.facing = 0.0f;
+	unit.radius = spec->second.radius;
+	unit.build_progress = 1.0f;
+	unit.cloak = sc2::Unit::CloakState::NotCloaked;
+	unit.detect_range = 0.0f;
+	unit.radar_range = 0.0f;
+	unit.is_selected = false;
+	unit.is_on_screen = false;
+	unit.is_blip = false;
+	unit.health = spec->second.health;
+	unit.health_max = spec->second.health;
+	unit.shield = 0.0f;
+	unit.shield_max = 0.0f;
+	unit.energy = 50.0f;
+	unit.energy_max = 200.0f;
+	unit.mineral_contents = isMineral(type) ? (type == sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD ? 1800 : 900) : 0;
+	unit.vespene_contents = type == sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER ? 2250 : 0;
+	unit.is_flying = spec->second.flying && spec->second.speed > 0.0f;
+	unit.is_burrowed = false;
+	unit.weapon_cooldown = 0.0f;
+	unit.add_on_tag = sc2::NullTag;
+	unit.cargo_space_taken = 0;
+	unit.cargo_space_max = 0;
+	unit.assigned_harvesters = 0;
+	unit.ideal_harvesters = spec->second.foodProvided >= 15 ? 16 : isGasBuilding(type) ? 3 : 0;
+	unit.engaged_target_tag = sc2::NullTag;
+	unit.is_powered = true;
+	unit.is_alive = true;
+	unit.last_seen_game_loop = m_gameLoop;
+	m_unitIndex[unit.tag] = m_units.size() - 1;
+	m_created.push_back(&unit);
+	return unit;
+}
+
+void MockGame::createBase(const sc2::Point2D & townHall, sc2::Unit::Alliance owner)
+{
+	// the resources lie on the side away from the map center
+	sc2::Point2D away = townHall - sc2::Point2D(m_width / 2.0f, m_height / 2.0f);
+	const float length = std::sqrt(away.x * away.x + away.y * away.y);
+	away = length > 0.0f ? away / length : sc2::Point2D(-1.0f, 0.0f);
+	for (int i = 0; i < 8; ++i)
+	{
+		const sc2::Point2D pos = townHall + rotate(away, (i - 3.5f) * 0.25f) * 7.0f;
+		addUnit(i % 2 ? sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD750 : sc2::UNIT_TYPEID::NEUTRAL_MINERALFIELD, sc2::Unit::Alliance::Neutral, sc2::Point2D(std::round(pos.x), std::floor(pos.y) + 0.5f));
+	}
+	for (const float angle : { -1.4f, 1.4f })
+	{
+		const sc2::Point2D pos = townHall + rotate(away, angle) * 7.5f;
+		addUnit(sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER, sc2::Unit::Alliance::Neutral, sc2::Point2D(std::floor(pos.x) + 0.5f, std::floor(pos.y) + 0.5f));
+	}
+	if (owner == sc2::Unit::Alliance::Neutral)
+	{
+		return;
+	}
+	const bool self = owner == sc2::Unit::Alliance::Self;
+	addUnit(self ? sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER : sc2::UNIT_TYPEID::PROTOSS_NEXUS, owner, townHall);
+	std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+	for (int i = 0; i < 12; ++i)
+	{
+		addUnit(self ? sc2::UNIT_TYPEID::TERRAN_SCV : sc2::UNIT_TYPEID::PROTOSS_PROBE, owner, townHall + away * 4.0f + sc2::Point2D(jitter(m_random), jitter(m_random)));
+	}
+}
+
+void MockGame::createArmy(const sc2::Point2D & pos)
+{
+	std::uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+	const std::vector<std::pair<sc2::UNIT_TYPEID, int>> army = { { sc2::UNIT_TYPEID::TERRAN_MARINE, 16 }, { sc2::UNIT_TYPEID::TERRAN_MARAUDER, 6 }, { sc2::UNIT_TYPEID::TERRAN_SIEGETANK, 2 }, { sc2::UNIT_TYPEID::TERRAN_MEDIVAC, 2 } };
+	for (const auto & group : army)
+	{
+		for (int i = 0; i < group.second; ++i)
+		{
+			addUnit(group.first, sc2::Unit::Alliance::Self, pos + sc2::Point2D(jitter(m_random), jitter(m_random)));
+		}
+	}
+}
+
+void MockGame::spawnWave()
+{
+	std::uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+	const sc2::Point2D rally = m_enemyStartLocation - sc2::Point2D(12.0f, 12.0f);
+	for (int i = 0; i < 8; ++i)
+	{
+		sc2::Unit & unit = addUnit(i % 2 ? sc2::UNIT_TYPEID::PROTOSS_STALKER : sc2::UNIT_TYPEID::PROTOSS_ZEALOT, sc2::Unit::Alliance::Enemy, rally + sc2::Point2D(jitter(m_random), jitter(m_random)));
+		order(&unit, sc2::ABILITY_ID::ATTACK_ATTACK, m_startLocation, nullptr, false);
+	}
+	m_commands.clear();
+
+	// every other wave storms our army, so the micro has something to dodge
+	if ((m_gameLoop / waveInterval) % 2 == 0)
+	{
+		const sc2::Units army = GetUnits(sc2::Unit::Alliance::Self, [](const sc2::Unit & unit) { return unit.unit_type == sc2::UNIT_TYPEID::TERRAN_MARINE; });
+		if (!army.empty())
+		{
+			sc2::Effect storm;
+			storm.effect_id = static_cast<uint32_t>(sc2::EFFECT_ID::PSISTORM);
+			storm.positions.push_back(army.front()->pos);
+			m_effects.assign(1, storm);
+			m_effectsUntil = m_gameLoop + stormDuration;
+		}
+	}
+	// stim wears off
+	for (auto & unit : m_units)
+	{
+		unit.buffs.clear();
+	}
+}
+
+void MockGame::updateVisibility()
+{
+	for (auto & tile : m_visibility)
+	{
+		tile = tile > 0 ? 1 : 0;
+	}
+	for (const auto & unit : m_units)
+	{
+		if (!unit.is_alive || unit.alliance != sc2::Unit::Alliance::Self)
+		{
+			continue;
+		}
+		const int sight = static_cast<int>(m_unitTypes[static_cast<size_t>(unit.unit_type.ToType())].sight_range);
+		for (int x = std::max(0, (int)unit.pos.x - sight); x <= std::min(m_width - 1, (int)unit.pos.x + sight); ++x)
+		{
+			for (int y = std::max(0, (int)unit.pos.y - sight); y <= std::min(m_height - 1, (int)unit.pos.y + sight); ++y)
+			{
+				const float dx = x + 0.5f - unit.pos.x;
+				const float dy = y + 0.5f - unit.pos.y;
+				if (dx * dx + dy * dy <= sight * sight)
+				{
+					m_visibility[x * m_height + y] = 2;
+				}
+			}
+		}
+	}
+}
+
+bool MockGame::isSeen(const sc2::Unit & unit) const
+{
+	const int x = static_cast<int>(unit.pos.x);
+	const int y = static_cast<int>(unit.pos.y);
+	return x >= 0 && y >= 0 && x < m_width && y < m_height && m_visibility[x * m_height + y] == 2;
+}
+
+sc2::Unit * MockGame::closestEnemy(const sc2::Unit & unit, float maxDistance)
+{
+	sc2::Unit * closest = nullptr;
+	float minDistance = maxDistance;
+	for (auto & other : m_units)
+	{
+		if (!other.is_alive || other.alliance == sc2::Unit::Alliance::Neutral || other.alliance == unit.alliance)
+		{
+			continue;
+		}
+		const float dist = sc2::Distance2D(unit.pos, other.pos);
+		if (dist < minDistance)
+		{
+			minDistance = dist;
+			closest = &other;
+		}
+	}
+	return closest;
+}
+
+// center is snapped to the grid. Town halls keep a gap of 3 tiles to resources.
+bool MockGame::isFree(const sc2::Point2D & center, float footprint, bool townHall) const
+{
+	for (int x = static_cast<int>(center.x - footprint); x < center.x + footprint; ++x)
+	{
+		for (int y = static_cast<int>(center.y - footprint); y < center.y + footprint; ++y)
+		{
+			if (!IsPlacable(sc2::Point2D(x + 0.5f, y + 0.5f)) || HasCreep(sc2::Point2D(x + 0.5f, y + 0.5f)))
+			{
+				return false;
+			}
+		}
+	}
+	for (const auto & unit : m_units)
+	{
+		if (!unit.is_alive)
+		{
+			continue;
+		}
+		const auto spec = m_specs.find(unit.unit_type.ToType());
+		float halfWidth = spec->second.footprint;
+		float halfHeight = spec->second.footprint;
+		if (isMineral(unit.unit_type))
+		{
+			halfWidth = 1.0f;
+			halfHeight = 0.5f;
+		}
+		else if (unit.unit_type == sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER)
+		{
+			halfWidth = halfHeight = 1.5f;
+		}
+		if (townHall && (isMineral(unit.unit_type) || unit.unit_type == sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER))
+		{
+			halfWidth += 3.0f;
+			halfHeight += 3.0f;
+		}
+		if (halfWidth > 0.0f && std::abs(unit.pos.x - center.x) < halfWidth + footprint && std::abs(unit.pos.y - center.y) < halfHeight + footprint)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int32_t MockGame::getFood(bool provided) const
+{
+	float food = 0.0f;
+	for (const auto & unit : m_units)
+	{
+		if (unit.is_alive && unit.alliance == sc2::Unit::Alliance::Self)
+		{
+			const TypeSpec & spec = m_specs.at(unit.unit_type.ToType());
+			food += provided ? spec.foodProvided : spec.food;
+		}
+	}
+	return std::min(200, static_cast<int32_t>(food));
+}
+
+void MockGame::updateUnit(sc2::Unit & unit, uint32_t loops)
+{
+	const TypeSpec & spec = m_specs.at(unit.unit_type.ToType());
+	unit.weapon_cooldown = std::max(0.0f, unit.weapon_cooldown - loops);
+	if (unit.orders.empty())
+	{
+		// the enemy army always attacks, ours only fights back
+		if (spec.range > 0.0f && spec.speed > 0.0f && unit.alliance == sc2::Unit::Alliance::Enemy && unit.unit_type != sc2::UNIT_TYPEID::PROTOSS_PROBE)
+		{
+			order(&unit, sc2::ABILITY_ID::ATTACK_ATTACK, m_startLocation, nullptr, false);
+		}
+		else if (spec.range > 0.0f && unit.alliance == sc2::Unit::Alliance::Self)
+		{
+			sc2::Unit * target = closestEnemy(unit, spec.range + unit.radius + 1.0f);
+			if (target && unit.weapon_cooldown == 0.0f)
+			{
+				target->health -= spec.damage;
+				unit.weapon_cooldown = spec.cooldown * loopsPerSecond;
+			}
+			return;
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	sc2::UnitOrder & current = unit.orders.front();
+	sc2::Unit * target = nullptr;
+	if (current.target_unit_tag != sc2::NullTag)
+	{
+		const auto index = m_unitIndex.find(current.target_unit_tag);
+		target = index != m_unitIndex.end() && m_units[index->second].is_alive ? &m_units[index->second] : nullptr;
+		if (!target)
+		{
+			unit.orders.erase(unit.orders.begin());
+			return;
+		}
+	}
+	const sc2::Point2D goal = target ? sc2::Point2D(target->pos) : current.target_pos;
+	const sc2::ABILITY_ID ability = current.ability_id.ToType();
+	const auto produces = m_produces.find(ability);
+
+	if (produces != m_produces.end())
+	{
+		const TypeSpec & product = m_specs.at(produces->second);
+		if (product.footprint > 0.0f && !moveTowards(unit, goal, spec.speed, loops) && sc2::Distance2D(unit.pos, goal) > product.footprint + 1.0f)
+		{
+			return;
+		}
+		const bool affordable = m_minerals >= product.minerals && m_vespene >= product.gas && (product.footprint > 0.0f || getFood(false) + product.food <= getFood(true));
+		const sc2::Point2D site = product.footprint > 0.0f && !target ? snapToGrid(goal, product.footprint) : goal;
+		if (affordable && (product.footprint == 0.0f || target || isFree(site, product.footprint, isTownHall(produces->second))))
+		{
+			m_minerals -= product.minerals;
+			m_vespene -= product.gas;
+			const sc2::Point2D pos = product.footprint > 0.0f ? site : sc2::Point2D(unit.pos) + sc2::Point2D(unit.radius + 1.0f, -unit.radius - 1.0f);
+			addUnit(produces->second, unit.alliance, pos);
+		}
+		unit.orders.erase(unit.orders.begin());
+		return;
+	}
+
+	const bool gather = ability == sc2::ABILITY_ID::HARVEST_GATHER || ability == sc2::ABILITY_ID::HARVEST_RETURN
+		|| (ability == sc2::ABILITY_ID::SMART && target && (isMineral(target->unit_type) || isGasBuilding(target->unit_type)));
+	if (gather)
+	{
+		if (target && sc2::Distance2D(unit.pos, target->pos) > target->radius + 1.5f)
+		{
+			moveTowards(unit, goal, spec.speed, loops);
+		}
+		else if (target && isGasBuilding(target->unit_type))
+		{
+			m_vespene += gasPerLoop * loops;
+		}
+		else
+		{
+			m_minerals += mineralsPerLoop * loops;
+		}
+		return;
+	}
+
+	const bool attack = ability == sc2::ABILITY_ID::ATTACK_ATTACK || (ability == sc2::ABILITY_ID::SMART && target && target->alliance != unit.alliance);
+	if (attack && spec.range > 0.0f)
+	{
+		if (!target)
+		{
+			target = closestEnemy(unit, spec.range + unit.radius + 3.0f);
+		}
+		if (target)
+		{
+			if (sc2::Distance2D(unit.pos, target->pos) - unit.radius - target->radius <= spec.range)
+			{
+				if (unit.weapon_cooldown == 0.0f)
+				{
+					target->health -= spec.damage;
+					unit.weapon_cooldown = spec.cooldown * loopsPerSecond;
+				}
+			}
+			else
+			{
+				moveTowards(unit, target->pos, spec.speed, loops);
+			}
+			return;
+		}
+	}
+
+	if (ability == sc2::ABILITY_ID::MOVE || ability == sc2::ABILITY_ID::SMART || attack)
+	{
+		if (spec.speed > 0.0f && !moveTowards(unit, goal, spec.speed, loops))
+		{
+			return;
+		}
+	}
+	unit.orders.erase(unit.orders.begin());
+}
+
+void MockGame::start(CCBot & bot)
+{
+	bot.setStandIns(this, this, this);
+	bot.OnGameStart();
+}
+
+void MockGame::step(CCBot & bot, uint32_t loops)
+{
+	m_gameLoop += loops;
+	if (m_gameLoop / waveInterval != (m_gameLoop - loops) / waveInterval)
+	{
+		spawnWave();
+	}
+	if (m_gameLoop >= m_effectsUntil)
+	{
+		m_effects.clear();
+	}
+
+	std::vector<sc2::Unit *> busy;
+	for (auto & unit : m_units)
+	{
+		if (!unit.is_alive || unit.alliance == sc2::Unit::Alliance::Neutral)
+		{
+			continue;
+		}
+		if (!unit.orders.empty())
+		{
+			busy.push_back(&unit);
+		}
+		updateUnit(unit, loops);
+	}
+	updateVisibility();
+
+	std::vector<sc2::Unit *> created;
+	created.swap(m_created);
+	for (auto unit : created)
+	{
+		if (unit->alliance == sc2::Unit::Alliance::Self)
+		{
+			bot.OnUnitCreated(unit);
+			if (m_specs.at(unit->unit_type.ToType()).footprint > 0.0f)
+			{
+				bot.OnBuildingConstructionComplete(unit);
+			}
+		}
+	}
+	for (auto & unit : m_units)
+	{
+		if (unit.is_alive && unit.health <= 0.0f)
+		{
+			unit.is_alive = false;
+			unit.orders.clear();
+			bot.OnUnitDestroyed(&unit);
+		}
+		else if (unit.is_alive && unit.alliance == sc2::Unit::Alliance::Enemy)
+		{
+			const bool seen = isSeen(unit);
+			if (seen && m_enemiesInVision.insert(unit.tag).second)
+			{
+				bot.OnUnitEnterVision(&unit);
+			}
+			else if (!seen)
+			{
+				m_enemiesInVision.erase(unit.tag);
+			}
+			unit.last_seen_game_loop = seen ? m_gameLoop : unit.last_seen_game_loop;
+		}
+	}
+	for (auto unit : busy)
+	{
+		if (unit->is_alive && unit->orders.empty() && unit->alliance == sc2::Unit::Alliance::Self)
+		{
+			bot.OnUnitIdle(unit);
+		}
+	}
+}
+
+void MockGame::order(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * target, bool queued)
+{
+	if (!unit || m_unitIndex.find(unit->tag) == m_unitIndex.end())
+	{
+		return;
+	}
+	// all units are ours to change, the interfaces just hand them out as const
+	sc2::Unit & commanded = m_units[m_unitIndex.at(unit->tag)];
+	m_commands.push_back(commanded.tag);
+	switch (ability.ToType())
+	{
+		case sc2::ABILITY_ID::STOP:
+			commanded.orders.clear();
+			return;
+		case sc2::ABILITY_ID::EFFECT_STIM:
+			if (std::find(commanded.buffs.begin(), commanded.buffs.end(), sc2::BUFF_ID::STIMPACK) == commanded.buffs.end())
+			{
+				commanded.buffs.push_back(sc2::BUFF_ID::STIMPACK);
+				commanded.health -= 10.0f;
+			}
+			return;
+		case sc2::ABILITY_ID::EFFECT_CALLDOWNMULE:
+			commanded.energy -= 50.0f;
+			return;
+		default:
+			break;
+	}
+	const bool produces = m_produces.find(ability.ToType()) != m_produces.end();
+	const bool targeted = target || point.x != 0.0f || point.y != 0.0f;
+	if (!produces && !targeted)
+	{
+		// morphs, research and the like finish at once and change nothing here
+		return;
+	}
+	sc2::UnitOrder newOrder;
+	newOrder.ability_id = ability;
+	newOrder.target_unit_tag = target ? target->tag : sc2::NullTag;
+	newOrder.target_pos = target ? sc2::Point2D(target->pos) : point;
+	newOrder.progress = 0.0f;
+	if (!queued)
+	{
+		commanded.orders.clear();
+	}
+	commanded.orders.push_back(newOrder);
+}
+
+uint32_t MockGame::GetPlayerID() const
+{
+	return 1;
+}
+
+uint32_t MockGame::GetGameLoop() const
+{
+	return m_gameLoop;
+}
+
+sc2::Units MockGame::GetUnits() const
+{
+	sc2::Units units;
+	for (const auto & unit : m_units)
+	{
+		if (unit.is_alive && (unit.alliance != sc2::Unit::Alliance::Enemy || isSeen(unit)))
+		{
+			units.push_back(&unit);
+		}
+	}
+	return units;
+}
+
+sc2::Units MockGame::GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter) const
+{
+	sc2::Units units;
+	for (const auto unit : GetUnits())
+	{
+		if (unit->alliance == alliance && (!filter || filter(*unit)))
+		{
+			units.push_back(unit);
+		}
+	}
+	return units;
+}
+
+sc2::Units MockGame::GetUnits(sc2::Filter filter) const
+{
+	sc2::Units units;
+	for (const auto unit : GetUnits())
+	{
+		if (!filter || filter(*unit))
+		{
+			units.push_back(unit);
+		}
+	}
+	return units;
+}
+
+const sc2::Unit * MockGame::GetUnit(sc2::Tag tag) const
+{
+	const auto index = m_unitIndex.find(tag);
+	if (index == m_unitIndex.end())
+	{
+		return nullptr;
+	}
+	const sc2::Unit & unit = m_units[index->second];
+	return unit.is_alive && (unit.alliance != sc2::Unit::Alliance::Enemy || isSeen(unit)) ? &unit : nullptr;
+}
+
+const sc2::RawActions & MockGame::GetRawActions() const
+{
+	return m_rawActions;
+}
+
+const sc2::SpatialActions & MockGame::GetFeatureLayerActions() const
+{
+	return m_spatialActions;
+}
+
+const sc2::SpatialActions & MockGame::GetRenderedActions() const
+{
+	return m_spatialActions;
+}
+
+const std::vector<sc2::ChatMessage> & MockGame::GetChatMessages() const
+{
+	return m_chat;
+}
+
+const std::vector<sc2::PowerSource> & MockGame::GetPowerSources() const
+{
+	return m_powerSources;
+}
+
+const std::vector<sc2::Effect> & MockGame::GetEffects() const
+{
+	return m_effects;
+}
+
+const std::vector<sc2::UpgradeID> & MockGame::GetUpgrades() const
+{
+	return m_finishedUpgrades;
+}
+
+const sc2::Score & MockGame::GetScore() const
+{
+	return m_score;
+}
+
+const sc2::Abilities & MockGame::GetAbilityData(bool) const
+{
+	return m_abilities;
+}
+
+const sc2::UnitTypes & MockGame::GetUnitTypeData(bool) const
+{
+	return m_unitTypes;
+}
+
+const sc2::Upgrades & MockGame::GetUpgradeData(bool) const
+{
+	return m_upgrades;
+}
+
+const sc2::Buffs & MockGame::GetBuffData(bool) const
+{
+	return m_buffs;
+}
+
+const sc2::Effects & MockGame::GetEffectData(bool) const
+{
+	return m_effectData;
+}
+
+const sc2::GameInfo & MockGame::GetGameInfo() const
+{
+	return m_gameInfo;
+}
+
+int32_t MockGame::GetMinerals() const
+{
+	return static_cast<int32_t>(m_minerals);
+}
+
+int32_t MockGame::GetVespene() const
+{
+	return static_cast<int32_t>(m_vespene);
+}
+
+int32_t MockGame::GetFoodCap() const
+{
+	return getFood(true);
+}
+
+int32_t MockGame::GetFoodUsed() const
+{
+	return getFood(false);
+}
+
+int32_t MockGame::GetFoodArmy() const
+{
+	return GetFoodUsed() - GetFoodWorkers();
+}
+
+int32_t MockGame::GetFoodWorkers() const
+{
+	return static_cast<int32_t>(GetUnits(sc2::Unit::Alliance::Self, sc2::IsUnit(sc2::UNIT_TYPEID::TERRAN_SCV)).size());
+}
+
+int32_t MockGame::GetIdleWorkerCount() const
+{
+	return static_cast<int32_t>(GetUnits(sc2::Unit::Alliance::Self, [](const sc2::Unit & unit) { return unit.unit_type == sc2::UNIT_TYPEID::TERRAN_SCV && unit.orders.empty(); }).size());
+}
+
+int32_t MockGame::GetArmyCount() const
+{
+	return static_cast<int32_t>(GetUnits(sc2::Unit::Alliance::Self, [this](const sc2::Unit & unit) { return m_specs.at(unit.unit_type.ToType()).range > 0.0f && unit.unit_type != sc2::UNIT_TYPEID::TERRAN_SCV; }).size());
+}
+
+int32_t MockGame::GetWarpGateCount() const
+{
+	return 0;
+}
+
+int32_t MockGame::GetLarvaCount() const
+{
+	return 0;
+}
+
+sc2::Point2D MockGame::GetCameraPos() const
+{
+	return m_startLocation;
+}
+
+sc2::Point3D MockGame::GetStartLocation() const
+{
+	return sc2::Point3D(m_startLocation.x, m_startLocation.y, groundHeight);
+}
+
+const std::vector<sc2::PlayerResult> & MockGame::GetResults() const
+{
+	return m_results;
+}
+
+bool MockGame::HasCreep(const sc2::Point2D & point) const
+{
+	const int x = static_cast<int>(point.x);
+	const int y = static_cast<int>(point.y);
+	return x >= 0 && y >= 0 && x < m_width && y < m_height && m_creep[x * m_height + y] != 0;
+}
+
+sc2::Visibility MockGame::GetVisibility(const sc2::Point2D & point) const
+{
+	const int x = static_cast<int>(point.x);
+	const int y = static_cast<int>(point.y);
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+	{
+		return sc2::Visibility::Hidden;
+	}
+	const uint8_t visibility = m_visibility[x * m_height + y];
+	return visibility == 2 ? sc2::Visibility::Visible : visibility == 1 ? sc2::Visibility::Fogged : sc2::Visibility::Hidden;
+}
+
+bool MockGame::IsPathable(const sc2::Point2D & point) const
+{
+	return Util::Pathable(m_gameInfo, point);
+}
+
+bool MockGame::IsPlacable(const sc2::Point2D & point) const
+{
+	return Util::Placement(m_gameInfo, point);
+}
+
+float MockGame::TerrainHeight(const sc2::Point2D & point) const
+{
+	return Util::TerainHeight(m_gameInfo, point);
+}
+
+const SC2APIProtocol::Observation * MockGame::GetRawObservation() const
+{
+	return nullptr;
+}
+
+sc2::AvailableAbilities MockGame::GetAbilitiesForUnit(const sc2::Unit * unit, bool)
+{
+	sc2::AvailableAbilities available;
+	available.unit_tag = unit->tag;
+	available.unit_type_id = unit->unit_type;
+	const auto abilities = m_unitAbilities.find(unit->unit_type.ToType());
+	if (abilities == m_unitAbilities.end())
+	{
+		return available;
+	}
+	for (const auto ability : abilities->second)
+	{
+		const bool stimmed = std::find(unit->buffs.begin(), unit->buffs.end(), sc2::BUFF_ID::STIMPACK) != unit->buffs.end();
+		if ((ability == sc2::ABILITY_ID::EFFECT_STIM && stimmed) || (ability == sc2::ABILITY_ID::EFFECT_CALLDOWNMULE && unit->energy < 50.0f))
+		{
+			continue;
+		}
+		sc2::AvailableAbility availableAbility;
+		availableAbility.ability_id = ability;
+		availableAbility.requires_point = false;
+		available.abilities.push_back(availableAbility);
+	}
+	return available;
+}
+
+std::vector<sc2::AvailableAbilities> MockGame::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	std::vector<sc2::AvailableAbilities> available;
+	for (const auto unit : units)
+	{
+		available.push_back(GetAbilitiesForUnit(unit, ignore_resource_requirements));
+	}
+	return available;
+}
+
+float MockGame::PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end)
+{
+	// the engine answers 0 if there is no path
+	return IsPathable(start) && IsPathable(end) ? sc2::Distance2D(start, end) : 0.0f;
+}
+
+float MockGame::PathingDistance(const sc2::Unit * start, const sc2::Point2D & end)
+{
+	return start ? PathingDistance(sc2::Point2D(start->pos), end) : 0.0f;
+}
+
+std::vector<float> MockGame::PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries)
+{
+	std::vector<float> distances;
+	for (const auto & query : queries)
+	{
+		distances.push_back(query.start_unit_tag_ != sc2::NullTag ? PathingDistance(GetUnit(query.start_unit_tag_), query.end_) : PathingDistance(query.start_, query.end_));
+	}
+	return distances;
+}
+
+bool MockGame::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit *)
+{
+	if (ability == sc2::ABILITY_ID::BUILD_REFINERY || ability == sc2::ABILITY_ID::BUILD_ASSIMILATOR)
+	{
+		// on a geyser nobody has taken yet
+		bool geyser = false;
+		for (const auto & unit : m_units)
+		{
+			if (unit.is_alive && sc2::Distance2D(unit.pos, target_pos) < 0.5f)
+			{
+				if (isGasBuilding(unit.unit_type))
+				{
+					return false;
+				}
+				geyser = geyser || unit.unit_type == sc2::UNIT_TYPEID::NEUTRAL_VESPENEGEYSER;
+			}
+		}
+		return geyser;
+	}
+	const float footprint = static_cast<size_t>(ability) < m_abilities.size() ? m_abilities[static_cast<size_t>(ability)].footprint_radius : 0.0f;
+	const auto produces = m_produces.find(ability.ToType());
+	return footprint == 0.0f || isFree(snapToGrid(target_pos, footprint), footprint, produces != m_produces.end() && isTownHall(produces->second));
+}
+
+std::vector<bool> MockGame::Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries)
+{
+	std::vector<bool> placeable;
+	for (const auto & query : queries)
+	{
+		placeable.push_back(Placement(query.ability, query.target_pos));
+	}
+	return placeable;
+}
+
+void MockGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command)
+{
+	order(unit, ability, sc2::Point2D(0.0f, 0.0f), nullptr, queued_command);
+}
+
+void MockGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	order(unit, ability, point, nullptr, queued_command);
+}
+
+void MockGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	order(unit, ability, sc2::Point2D(0.0f, 0.0f), target, queued_command);
+}
+
+void MockGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move)
+{
+	for (const auto unit : units)
+	{
+		UnitCommand(unit, ability, queued_move);
+	}
+}
+
+void MockGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	for (const auto unit : units)
+	{
+		UnitCommand(unit, ability, point, queued_command);
+	}
+}
+
+void MockGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	for (const auto unit : units)
+	{
+		UnitCommand(unit, ability, target, queued_command);
+	}
+}
+
+const std::vector<sc2::Tag> & MockGame::Commands() const
+{
+	return m_commands;
+}
+
+void MockGame::ToggleAutocast(sc2::Tag, sc2::AbilityID)
+{
+
+}
+
+void MockGame::ToggleAutocast(const std::vector<sc2::Tag> &, sc2::AbilityID)
+{
+
+}
+
+void MockGame::SendChat(const std::string &, sc2::ChatChannel)
+{
+
+}
+
+void MockGame::SendActions()
+{
+	m_commands.clear();
+}
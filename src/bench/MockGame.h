@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Common.h"
+#include <deque>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+class CCBot;
+
+// stands in for StarCraft, so the bot can be timed on any box. It answers the parts of the observation, query and action
+// interfaces the bot uses, the rest answers empty. The world is synthetic: an open map with a few cliffs and optionally
+// rocks, mirrored bases, creep at two bases on the enemy side, our main with workers and an army, and enemy waves that walk into our main.
+// Units follow their orders, fight and die, workers mine and build, production is instant. Pathing distances are straight lines.
+// Placement follows the rules of the game for structures: the grid, creep, other structures and the gap of town halls to resources.
+class MockGame : public sc2::ObservationInterface, public sc2::QueryInterface, public sc2::ActionInterface
+{
+	struct TypeSpec
+	{
+		sc2::UNIT_TYPEID	type;
+		sc2::Race			race;
+		int					minerals;
+		int					gas;
+		float				food;
+		float				foodProvided;
+		sc2::ABILITY_ID		ability;		// the ability that builds or trains it
+		float				footprint;		// radius of the building footprint, 0 for units
+		float				radius;
+		float				health;
+		float				speed;
+		float				range;			// 0 for no weapon
+		float				damage;
+		float				cooldown;		// seconds between attacks
+		bool				flying;
+	};
+
+	int									m_width;
+	int									m_height;
+	uint32_t							m_gameLoop;
+	sc2::Tag							m_nextTag;
+	std::mt19937						m_random;
+	sc2::GameInfo						m_gameInfo;
+	sc2::Point2D						m_startLocation;
+	sc2::Point2D						m_enemyStartLocation;
+	std::vector<sc2::Point2D>			m_bases;		// our half, the enemy gets the same spots mirrored
+	std::deque<sc2::Unit>				m_units;		// a deque keeps the unit pointers valid when units are added
+	std::unordered_map<sc2::Tag, size_t>	m_unitIndex;
+	std::vector<sc2::Unit *>			m_created;		// since the last step, the bot hears about them then
+	std::vector<uint8_t>				m_visibility;	// 0 never seen, 1 fogged, 2 visible. x * height + y
+	std::vector<uint8_t>				m_creep;		// x * height + y
+	std::map<sc2::UNIT_TYPEID, TypeSpec>	m_specs;
+	std::map<sc2::ABILITY_ID, sc2::UNIT_TYPEID>	m_produces;
+	std::map<sc2::UNIT_TYPEID, std::vector<sc2::ABILITY_ID>>	m_unitAbilities;
+	sc2::UnitTypes						m_unitTypes;
+	sc2::Abilities						m_abilities;
+	sc2::Upgrades						m_upgrades;
+	sc2::Buffs							m_buffs;
+	sc2::Effects						m_effectData;
+	std::vector<sc2::Effect>			m_effects;
+	uint32_t							m_effectsUntil;
+	std::unordered_set<sc2::Tag>		m_enemiesInVision;
+	std::vector<sc2::UpgradeID>			m_finishedUpgrades;
+	std::vector<sc2::PowerSource>		m_powerSources;
+	std::vector<sc2::Tag>				m_commands;
+	sc2::RawActions						m_rawActions;
+	sc2::SpatialActions					m_spatialActions;
+	std::vector<sc2::ChatMessage>		m_chat;
+	sc2::Score							m_score;
+	std::vector<sc2::PlayerResult>		m_results;
+	float								m_minerals;
+	float								m_vespene;
+
+	void			createTypeData();
+	void			addSpec(const TypeSpec & spec, const std::vector<sc2::ABILITY_ID> & abilities = {});
+	void			createMap(float obstacleDensity);
+	void			addRocks(float obstacleDensity);
+	void			createBase(const sc2::Point2D & townHall, sc2::Unit::Alliance owner);
+	void			createArmy(const sc2::Point2D & pos);
+	sc2::Unit &		addUnit(sc2::UNIT_TYPEID type, sc2::Unit::Alliance alliance, const sc2::Point2D & pos);
+	void			spawnWave();
+	void			updateVisibility();
+	void			updateUnit(sc2::Unit & unit, uint32_t loops);
+	sc2::Unit *		closestEnemy(const sc2::Unit & unit, float maxDistance);
+	bool			isFree(const sc2::Point2D & center, float footprint, bool townHall) const;
+	bool			isSeen(const sc2::Unit & unit) const;
+	void			order(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * target, bool queued);
+	int32_t			getFood(bool provided) const;
+
+public:
+
+	// obstacleDensity is the share of the playable area covered by rocks, they keep away from the bases
+	MockGame(int width = 160, int height = 160, unsigned seed = 1, float obstacleDensity = 0.0f);
+
+	// advances the world by loops game loops and tells the bot about units that appeared, died or went idle
+	void	step(CCBot & bot, uint32_t loops);
+	// the events the game sends at game start
+	void	start(CCBot & bot);
+
+	// ObservationInterface
+	uint32_t	GetPlayerID() const override;
+	uint32_t	GetGameLoop() const override;
+	sc2::Units	GetUnits() const override;
+	sc2::Units	GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter = {}) const override;
+	sc2::Units	GetUnits(sc2::Filter filter) const override;
+	const sc2::Unit *	GetUnit(sc2::Tag tag) const override;
+	const sc2::RawActions &	GetRawActions() const override;
+	const sc2::SpatialActions &	GetFeatureLayerActions() const override;
+	const sc2::SpatialActions &	GetRenderedActions() const override;
+	const std::vector<sc2::ChatMessage> &	GetChatMessages() const override;
+	const std::vector<sc2::PowerSource> &	GetPowerSources() const override;
+	const std::vector<sc2::Effect> &	GetEffects() const override;
+	const std::vector<sc2::UpgradeID> &	GetUpgrades() const override;
+	const sc2::Score &	GetScore() const override;
+	const sc2::Abilities &	GetAbilityData(bool force_refresh = false) const override;
+	const sc2::UnitTypes &	GetUnitTypeData(bool force_refresh = false) const override;
+	const sc2::Upgrades &	GetUpgradeData(bool force_refresh = false) const override;
+	const sc2::Buffs &	GetBuffData(bool force_refresh = false) const override;
+	const sc2::Effects &	GetEffectData(bool force_refresh = false) const override;
+	const sc2::GameInfo &	GetGameInfo() const override;
+	int32_t		GetMinerals() const override;
+	int32_t		GetVespene() const override;
+	int32_t		GetFoodCap() const override;
+	int32_t		GetFoodUsed() const override;
+	int32_t		GetFoodArmy() const override;
+	int32_t		GetFoodWorkers() const override;
+	int32_t		GetIdleWorkerCount() const override;
+	int32_t		GetArmyCount() const override;
+	int32_t		GetWarpGateCount() const override;
+	int32_t		GetLarvaCount() const override;
+	sc2::Point2D	GetCameraPos() const override;
+	sc2::Point3D	GetStartLocation() const override;
+	const std::vector<sc2::PlayerResult> &	GetResults() const override;
+	bool		HasCreep(const sc2::Point2D & point) const override;
+	sc2::Visibility	GetVisibility(const sc2::Point2D & point) const override;
+	bool		IsPathable(const sc2::Point2D & point) const override;
+	bool		IsPlacable(const sc2::Point2D & point) const override;
+	float		TerrainHeight(const sc2::Point2D & point) const override;
+	const SC2APIProtocol::Observation *	GetRawObservation() const override;
+
+	// QueryInterface
+	sc2::AvailableAbilities	GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities>	GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	float		PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end) override;
+	float		PathingDistance(const sc2::Unit * start, const sc2::Point2D & end) override;
+	std::vector<float>	PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries) override;
+	bool		Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+	std::vector<bool>	Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries) override;
+
+	// ActionInterface
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	const std::vector<sc2::Tag> &	Commands() const override;
+	void	ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) override;
+	void	ToggleAutocast(const std::vector<sc2::Tag> & unit_tags, sc2::AbilityID ability) override;
+	void	SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) override;
+	void	SendActions() override;
+};
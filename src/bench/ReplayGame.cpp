@@ -0,0 +1,462 @@
+#include "ReplayGame.h"
+#include "CCBot.h"
+#include "Util.h"
+
+ReplayGame::ReplayGame()
+	: m_missingAnswers(0)
+{
+
+}
+
+bool ReplayGame::open(const std::string & fileName)
+{
+	return m_file.open(fileName) && m_file.read(m_game);
+}
+
+void ReplayGame::start(CCBot & bot)
+{
+	m_step = m_game.start;
+	showStep();
+	bot.setStandIns(this, this, this);
+	bot.OnGameStart();
+}
+
+bool ReplayGame::step(CCBot & bot)
+{
+	m_lastStep = std::move(m_step);
+	m_step = RecordedStep();
+	if (!m_file.read(m_step))
+	{
+		return false;
+	}
+	showStep();
+
+	for (const auto & event : m_step.events)
+	{
+		sc2::Unit * unit = updateUnit(event.unit);
+		switch (event.type)
+		{
+			case RecordedEventType::Created:				bot.OnUnitCreated(unit); break;
+			case RecordedEventType::Destroyed:				bot.OnUnitDestroyed(unit); break;
+			case RecordedEventType::Idle:					bot.OnUnitIdle(unit); break;
+			case RecordedEventType::ConstructionComplete:	bot.OnBuildingConstructionComplete(unit); break;
+			case RecordedEventType::EnterVision:			bot.OnUnitEnterVision(unit); break;
+		}
+	}
+	bot.Scheduler().replayNextRun(m_step.tasks);
+	return true;
+}
+
+void ReplayGame::stepAhead(CCBot & bot)
+{
+	if (m_step.ranAhead)
+	{
+		bot.Scheduler().replayNextRun(m_step.aheadTasks);
+		bot.OnStepAhead();
+	}
+}
+
+const RecordedStep & ReplayGame::getStep() const
+{
+	return m_step;
+}
+
+const std::vector<RecordedAction> & ReplayGame::getActions() const
+{
+	return m_actions;
+}
+
+size_t ReplayGame::getMissingAnswers() const
+{
+	return m_missingAnswers;
+}
+
+// units keep their address for the whole game, the bot holds on to them
+sc2::Unit * ReplayGame::updateUnit(const sc2::Unit & unit)
+{
+	const auto index = m_unitIndex.find(unit.tag);
+	if (index != m_unitIndex.end())
+	{
+		m_units[index->second] = unit;
+		return &m_units[index->second];
+	}
+	m_units.push_back(unit);
+	m_unitIndex[unit.tag] = m_units.size() - 1;
+	return &m_units.back();
+}
+
+void ReplayGame::showStep()
+{
+	m_observed.clear();
+	for (const auto & unit : m_step.units)
+	{
+		m_observed.push_back(updateUnit(unit));
+	}
+}
+
+template <typename Key, typename Value>
+Value ReplayGame::answer(std::map<Key, Value> RecordedStep::* answers, const Key & key)
+{
+	const auto current = (m_step.*answers).find(key);
+	if (current != (m_step.*answers).end())
+	{
+		return current->second;
+	}
+	const auto last = (m_lastStep.*answers).find(key);
+	if (last != (m_lastStep.*answers).end())
+	{
+		return last->second;
+	}
+	++m_missingAnswers;
+	return Value();
+}
+
+uint32_t ReplayGame::GetPlayerID() const
+{
+	return m_game.playerID;
+}
+
+uint32_t ReplayGame::GetGameLoop() const
+{
+	return m_step.gameLoop;
+}
+
+sc2::Units ReplayGame::GetUnits() const
+{
+	return m_observed;
+}
+
+sc2::Units ReplayGame::GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter) const
+{
+	sc2::Units units;
+	for (const auto unit : m_observed)
+	{
+		if (unit->alliance == alliance && (!filter || filter(*unit)))
+		{
+			units.push_back(unit);
+		}
+	}
+	return units;
+}
+
+sc2::Units ReplayGame::GetUnits(sc2::Filter filter) const
+{
+	sc2::Units units;
+	for (const auto unit : m_observed)
+	{
+		if (!filter || filter(*unit))
+		{
+			units.push_back(unit);
+		}
+	}
+	return units;
+}
+
+// like the game's unit pool, it knows every unit that was ever observed
+const sc2::Unit * ReplayGame::GetUnit(sc2::Tag tag) const
+{
+	const auto index = m_unitIndex.find(tag);
+	return index != m_unitIndex.end() ? &m_units[index->second] : nullptr;
+}
+
+const sc2::RawActions & ReplayGame::GetRawActions() const
+{
+	return m_rawActions;
+}
+
+const sc2::SpatialActions & ReplayGame::GetFeatureLayerActions() const
+{
+	return m_spatialActions;
+}
+
+const sc2::SpatialActions & ReplayGame::GetRenderedActions() const
+{
+	return m_spatialActions;
+}
+
+const std::vector<sc2::ChatMessage> & ReplayGame::GetChatMessages() const
+{
+	return m_chat;
+}
+
+const std::vector<sc2::PowerSource> & ReplayGame::GetPowerSources() const
+{
+	return m_step.powerSources;
+}
+
+const std::vector<sc2::Effect> & ReplayGame::GetEffects() const
+{
+	return m_step.effects;
+}
+
+const std::vector<sc2::UpgradeID> & ReplayGame::GetUpgrades() const
+{
+	return m_step.upgrades;
+}
+
+const sc2::Score & ReplayGame::GetScore() const
+{
+	return m_score;
+}
+
+const sc2::Abilities & ReplayGame::GetAbilityData(bool) const
+{
+	return m_game.abilities;
+}
+
+const sc2::UnitTypes & ReplayGame::GetUnitTypeData(bool) const
+{
+	return m_game.unitTypes;
+}
+
+const sc2::Upgrades & ReplayGame::GetUpgradeData(bool) const
+{
+	return m_game.upgrades;
+}
+
+const sc2::Buffs & ReplayGame::GetBuffData(bool) const
+{
+	return m_game.buffs;
+}
+
+const sc2::Effects & ReplayGame::GetEffectData(bool) const
+{
+	return m_game.effects;
+}
+
+const sc2::GameInfo & ReplayGame::GetGameInfo() const
+{
+	return m_game.gameInfo;
+}
+
+int32_t ReplayGame::GetMinerals() const
+{
+	return m_step.minerals;
+}
+
+int32_t ReplayGame::GetVespene() const
+{
+	return m_step.vespene;
+}
+
+int32_t ReplayGame::GetFoodCap() const
+{
+	return m_step.foodCap;
+}
+
+int32_t ReplayGame::GetFoodUsed() const
+{
+	return m_step.foodUsed;
+}
+
+int32_t ReplayGame::GetFoodArmy() const
+{
+	return m_step.foodUsed - m_step.foodWorkers;
+}
+
+int32_t ReplayGame::GetFoodWorkers() const
+{
+	return m_step.foodWorkers;
+}
+
+int32_t ReplayGame::GetIdleWorkerCount() const
+{
+	return 0;
+}
+
+int32_t ReplayGame::GetArmyCount() const
+{
+	return 0;
+}
+
+int32_t ReplayGame::GetWarpGateCount() const
+{
+	return 0;
+}
+
+int32_t ReplayGame::GetLarvaCount() const
+{
+	return 0;
+}
+
+sc2::Point2D ReplayGame::GetCameraPos() const
+{
+	return m_step.camera;
+}
+
+sc2::Point3D ReplayGame::GetStartLocation() const
+{
+	return m_game.startLocation;
+}
+
+const std::vector<sc2::PlayerResult> & ReplayGame::GetResults() const
+{
+	return m_results;
+}
+
+bool ReplayGame::HasCreep(const sc2::Point2D & point) const
+{
+	const int x = static_cast<int>(point.x);
+	const int y = static_cast<int>(point.y);
+	const int width = m_game.gameInfo.width;
+	const size_t i = x + y * width;
+	return x >= 0 && y >= 0 && x < width && i < m_step.creep.size() && m_step.creep[i] != 0;
+}
+
+sc2::Visibility ReplayGame::GetVisibility(const sc2::Point2D & point) const
+{
+	const int x = static_cast<int>(point.x);
+	const int y = static_cast<int>(point.y);
+	const int width = m_game.gameInfo.width;
+	const size_t i = x + y * width;
+	if (x < 0 || y < 0 || x >= width || i >= m_step.visibility.size())
+	{
+		return sc2::Visibility::Hidden;
+	}
+	return static_cast<sc2::Visibility>(m_step.visibility[i]);
+}
+
+bool ReplayGame::IsPathable(const sc2::Point2D & point) const
+{
+	return Util::Pathable(m_game.gameInfo, point);
+}
+
+bool ReplayGame::IsPlacable(const sc2::Point2D & point) const
+{
+	return Util::Placement(m_game.gameInfo, point);
+}
+
+float ReplayGame::TerrainHeight(const sc2::Point2D & point) const
+{
+	return Util::TerainHeight(m_game.gameInfo, point);
+}
+
+const SC2APIProtocol::Observation * ReplayGame::GetRawObservation() const
+{
+	return nullptr;
+}
+
+sc2::AvailableAbilities ReplayGame::GetAbilitiesForUnit(const sc2::Unit * unit, bool)
+{
+	sc2::AvailableAbilities abilities = answer(&RecordedStep::abilities, unit->tag);
+	abilities.unit_tag = unit->tag;
+	abilities.unit_type_id = unit->unit_type;
+	return abilities;
+}
+
+std::vector<sc2::AvailableAbilities> ReplayGame::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	std::vector<sc2::AvailableAbilities> abilities;
+	for (const auto unit : units)
+	{
+		abilities.push_back(GetAbilitiesForUnit(unit, ignore_resource_requirements));
+	}
+	return abilities;
+}
+
+float ReplayGame::PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end)
+{
+	return answer(&RecordedStep::pathing, PathingKey{ sc2::NullTag, start, end });
+}
+
+float ReplayGame::PathingDistance(const sc2::Unit * start, const sc2::Point2D & end)
+{
+	return answer(&RecordedStep::pathing, PathingKey{ start->tag, sc2::Point2D(), end });
+}
+
+std::vector<float> ReplayGame::PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries)
+{
+	std::vector<float> distances;
+	for (const auto & query : queries)
+	{
+		distances.push_back(answer(&RecordedStep::pathing, PathingKey{ query.start_unit_tag_, query.start_, query.end_ }));
+	}
+	return distances;
+}
+
+bool ReplayGame::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit)
+{
+	return answer(&RecordedStep::placement, PlacementKey{ ability, target_pos, unit ? unit->tag : sc2::NullTag });
+}
+
+std::vector<bool> ReplayGame::Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries)
+{
+	std::vector<bool> placeable;
+	for (const auto & query : queries)
+	{
+		placeable.push_back(answer(&RecordedStep::placement, PlacementKey{ query.ability, query.target_pos, query.placing_unit_tag }));
+	}
+	return placeable;
+}
+
+void ReplayGame::addAction(RecordedAction::Target target, const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * targetUnit, bool queued)
+{
+	RecordedAction action;
+	action.target = target;
+	for (const auto unit : units)
+	{
+		action.units.push_back(unit->tag);
+		m_commands.push_back(unit->tag);
+	}
+	action.ability = ability;
+	action.point = point;
+	action.targetTag = targetUnit ? targetUnit->tag : sc2::NullTag;
+	action.queued = queued;
+	m_actions.push_back(action);
+}
+
+void ReplayGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command)
+{
+	addAction(RecordedAction::Target::None, { unit }, ability, sc2::Point2D(), nullptr, queued_command);
+}
+
+void ReplayGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	addAction(RecordedAction::Target::Point, { unit }, ability, point, nullptr, queued_command);
+}
+
+void ReplayGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	addAction(RecordedAction::Target::Unit, { unit }, ability, sc2::Point2D(), target, queued_command);
+}
+
+void ReplayGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move)
+{
+	addAction(RecordedAction::Target::None, units, ability, sc2::Point2D(), nullptr, queued_move);
+}
+
+void ReplayGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	addAction(RecordedAction::Target::Point, units, ability, point, nullptr, queued_command);
+}
+
+void ReplayGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	addAction(RecordedAction::Target::Unit, units, ability, sc2::Point2D(), target, queued_command);
+}
+
+const std::vector<sc2::Tag> & ReplayGame::Commands() const
+{
+	return m_commands;
+}
+
+void ReplayGame::ToggleAutocast(sc2::Tag, sc2::AbilityID)
+{
+
+}
+
+void ReplayGame::ToggleAutocast(const std::vector<sc2::Tag> &, sc2::AbilityID)
+{
+
+}
+
+void ReplayGame::SendChat(const std::string &, sc2::ChatChannel)
+{
+
+}
+
+void ReplayGame::SendActions()
+{
+	m_actions.clear();
+	m_commands.clear();
+}
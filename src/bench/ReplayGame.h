@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Common.h"
+#include "ObservationRecord.h"
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+class CCBot;
+
+// stands in for the game with a record of the ObservationRecorder. Each step shows the recorded observation, answers
+// the queries as the game did, sends the recorded events and makes the scheduler run the tasks that ran then.
+// The commands of the bot are kept, so they can be compared to the recorded ones.
+class ReplayGame : public sc2::ObservationInterface, public sc2::QueryInterface, public sc2::ActionInterface
+{
+	RecordFileReader						m_file;
+	RecordedGame							m_game;
+	RecordedStep							m_step;
+	RecordedStep							m_lastStep;		// events come before their step, the game answered them in the step before
+	std::deque<sc2::Unit>					m_units;		// a deque keeps the unit pointers valid, as the game's unit pool does
+	std::unordered_map<sc2::Tag, size_t>	m_unitIndex;
+	sc2::Units								m_observed;
+	std::vector<RecordedAction>				m_actions;
+	std::vector<sc2::Tag>					m_commands;
+	std::atomic<size_t>						m_missingAnswers;
+	sc2::RawActions							m_rawActions;
+	sc2::SpatialActions						m_spatialActions;
+	std::vector<sc2::ChatMessage>			m_chat;
+	sc2::Score								m_score;
+	std::vector<sc2::PlayerResult>			m_results;
+
+	sc2::Unit *	updateUnit(const sc2::Unit & unit);
+	void		showStep();
+	void		addAction(RecordedAction::Target target, const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, const sc2::Unit * targetUnit, bool queued);
+	template <typename Key, typename Value>
+	Value		answer(std::map<Key, Value> RecordedStep::* answers, const Key & key);
+
+public:
+
+	ReplayGame();
+
+	bool	open(const std::string & fileName);
+	// the events the game sends at game start
+	void	start(CCBot & bot);
+	// shows the next recorded step and sends its events, false at the end of the record
+	bool	step(CCBot & bot);
+	// runs OnStepAhead if the recorded game did
+	void	stepAhead(CCBot & bot);
+	const RecordedStep &	getStep() const;
+	// the commands of the bot since the last SendActions
+	const std::vector<RecordedAction> &	getActions() const;
+	// queries the record has no answer for, the replay then differs from the game
+	size_t	getMissingAnswers() const;
+
+	// ObservationInterface
+	uint32_t	GetPlayerID() const override;
+	uint32_t	GetGameLoop() const override;
+	sc2::Units	GetUnits() const override;
+	sc2::Units	GetUnits(sc2::Unit::Alliance alliance, sc2::Filter filter = {}) const override;
+	sc2::Units	GetUnits(sc2::Filter filter) const override;
+	const sc2::Unit *	GetUnit(sc2::Tag tag) const override;
+	const sc2::RawActions &	GetRawActions() const override;
+	const sc2::SpatialActions &	GetFeatureLayerActions() const override;
+	const sc2::SpatialActions &	GetRenderedActions() const override;
+	const std::vector<sc2::ChatMessage> &	GetChatMessages() const override;
+	const std::vector<sc2::PowerSource> &	GetPowerSources() const override;
+	const std::vector<sc2::Effect> &	GetEffects() const override;
+	const std::vector<sc2::UpgradeID> &	GetUpgrades() const override;
+	const sc2::Score &	GetScore() const override;
+	const sc2::Abilities &	GetAbilityData(bool force_refresh = false) const override;
+	const sc2::UnitTypes &	GetUnitTypeData(bool force_refresh = false) const override;
+	const sc2::Upgrades &	GetUpgradeData(bool force_refresh = false) const override;
+	const sc2::Buffs &	GetBuffData(bool force_refresh = false) const override;
+	const sc2::Effects &	GetEffectData(bool force_refresh = false) const override;
+	const sc2::GameInfo &	GetGameInfo() const override;
+	int32_t		GetMinerals() const override;
+	int32_t		GetVespene() const override;
+	int32_t		GetFoodCap() const override;
+	int32_t		GetFoodUsed() const override;
+	int32_t		GetFoodArmy() const override;
+	int32_t		GetFoodWorkers() const override;
+	int32_t		GetIdleWorkerCount() const override;
+	int32_t		GetArmyCount() const override;
+	int32_t		GetWarpGateCount() const override;
+	int32_t		GetLarvaCount() const override;
+	sc2::Point2D	GetCameraPos() const override;
+	sc2::Point3D	GetStartLocation() const override;
+	const std::vector<sc2::PlayerResult> &	GetResults() const override;
+	bool		HasCreep(const sc2::Point2D & point) const override;
+	sc2::Visibility	GetVisibility(const sc2::Point2D & point) const override;
+	bool		IsPathable(const sc2::Point2D & point) const override;
+	bool		IsPlacable(const sc2::Point2D & point) const override;
+	float		TerrainHeight(const sc2::Point2D & point) const override;
+	const SC2APIProtocol::Observation *	GetRawObservation() const override;
+
+	// QueryInterface
+	sc2::AvailableAbilities	GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities>	GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	float		PathingDistance(const sc2::Point2D & start, const sc2::Point2D & end) override;
+	float		PathingDistance(const sc2::Unit * start, const sc2::Point2D & end) override;
+	std::vector<float>	PathingDistance(const std::vector<sc2::QueryInterface::PathingQuery> & queries) override;
+	bool		Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+	std::vector<bool>	Placement(const std::vector<sc2::QueryInterface::PlacementQuery> & queries) override;
+
+	// ActionInterface
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void	UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	const std::vector<sc2::Tag> &	Commands() const override;
+	void	ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) override;
+	void	ToggleAutocast(const std::vector<sc2::Tag> & unit_tags, sc2::AbilityID ability) override;
+	void	SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) override;
+	void	SendActions() override;
+};
@@ -41,9 +41,9 @@ int main(int argc, char* argv[])
 			std::cout << "Unable to find or parse settings." << std::endl;
 			return 1;
 		}
-		// WARNING: Bot logic has not been thorougly tested on step sizes > 1
-		//		  Setting this = N means the bot's onFrame gets called once every N frames
-		//		  The bot may crash or do unexpected things if its logic is not called every frame
+		// Setting this = N means the bot's onFrame gets called once every N game loops.
+		// The managers reason in game loops, not in calls, and micro that needs to react
+		// within a loop asks for a fine step, so 2-4 is fine for faster self-play.
 		coordinator.SetStepSize(stepSize);
 		coordinator.SetRealtime(false);
 		coordinator.SetMultithreaded(true);
@@ -60,8 +60,41 @@ int main(int argc, char* argv[])
 
 
 		// Step forward the game simulation.
-		while (coordinator.Update())
+		if (bot.Config().PipelineSteps || stepSize > 1)
 		{
+			// the same as coordinator.Update, but the bot may shorten the next step for micro
+			// and production, economy and scouting can think while the game simulates
+			while (bot.Control()->IsInGame())
+			{
+				if (!bot.Control()->Step(bot.getStepSize(stepSize)))
+				{
+					break;
+				}
+				if (bot.Config().PipelineSteps)
+				{
+					bot.OnStepAhead();
+				}
+				bool stepped;
+				{
+					ProfileScope wait(bot.Profiler(), "WaitStep", "api");
+					stepped = bot.Control()->WaitStep();
+				}
+				if (!stepped || !bot.Control()->IsInGame())
+				{
+					break;
+				}
+				bot.Control()->IssueEvents(bot.sc2::Agent::Actions()->Commands());
+				bot.OnStep();
+				ProfileScope send(bot.Profiler(), "SendActions", "api");
+				bot.sc2::Agent::Actions()->SendActions();
+			}
+			bot.OnGameEnd();
+		}
+		else
+		{
+			while (coordinator.Update())
+			{
+			}
 		}
 		if (bot.Control()->SaveReplay("C:/Users/D/Documents/StarCraft II/Accounts/115842237/2-S2-1-1338490/Replays/Multiplayer/asdf.Sc2Replay"))
 		{
@@ -38,8 +38,8 @@ const float pathPlaning::calcThreatLvl(sc2::Point2D pos) const
 	{
 		const UnitInfo & ui(kv.second);
 
-		// if it's a combat unit
-		if (Util::IsCombatUnitType(ui.type, m_bot))
+		// if it's a combat unit and we have some idea where it is
+		if (Util::IsCombatUnitType(ui.type, m_bot) && ui.confidence > 0.0f)
 		{
 			//Get its weapon
 			std::vector<sc2::Weapon> weapons = m_bot.Observation()->GetUnitTypeData()[ui.type].weapons;
@@ -57,11 +57,11 @@ const float pathPlaning::calcThreatLvl(sc2::Point2D pos) const
 				}
 			}
 
-			//If we are in range.
-			float dist = Util::Dist(ui.lastPosition, pos);
+			//If we are in range. Units in the fog could be anywhere in their uncertainty radius, but we trust that less.
+			float dist = std::max(0.0f, Util::Dist(ui.predictedPosition, pos) - ui.uncertainty);
 			if (dist < range) 
 			{
-				threatLvl += dps*(range - dist) / range;
+				threatLvl += ui.confidence*dps*(range - dist) / range;
 			}
 		}
 	}
@@ -70,6 +70,7 @@ const float pathPlaning::calcThreatLvl(sc2::Point2D pos) const
 
 std::vector<sc2::Point2D> pathPlaning::planPath()
 {
+	ProfileScope profile(m_bot.Profiler(), "pathPlaning");
 	while (!m_openList.empty())
 	{
 		std::shared_ptr<node> frontNode = getBestNextNodeAndPop();